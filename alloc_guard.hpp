@@ -0,0 +1,79 @@
+#pragma once
+
+// Debug check that a steady-state tick never touches the heap. Building
+// with POKEBUDDY_ALLOC_GUARD replaces the global operator new; while an
+// AllocGuardScope is open, every allocation is reported together with the
+// tick stage that made it (ALLOC_STAGE), so a regression names its call
+// site. Allocations that are the point of an event (a new bag entry) are
+// wrapped in AllocGuardAllow. Without the define everything compiles away.
+//
+// The operator new replacement lives here, so include this header from
+// exactly one translation unit.
+
+#ifdef POKEBUDDY_ALLOC_GUARD
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Gets the finished message; stderr when unset.
+inline void (*allocGuardReport)(const char* message) = nullptr;
+
+inline thread_local const char* allocGuardStage = nullptr;
+inline thread_local int allocGuardDepth = 0;   // open AllocGuardScopes
+inline thread_local int allocGuardAllowed = 0; // open AllocGuardAllows
+inline thread_local bool allocGuardReporting = false;
+
+struct AllocGuardScope {
+    AllocGuardScope() { ++allocGuardDepth; }
+    ~AllocGuardScope() {
+        if (--allocGuardDepth == 0) allocGuardStage = nullptr;
+    }
+    AllocGuardScope(const AllocGuardScope&) = delete;
+    AllocGuardScope& operator=(const AllocGuardScope&) = delete;
+};
+
+struct AllocGuardAllow {
+    AllocGuardAllow() { ++allocGuardAllowed; }
+    ~AllocGuardAllow() { --allocGuardAllowed; }
+    AllocGuardAllow(const AllocGuardAllow&) = delete;
+    AllocGuardAllow& operator=(const AllocGuardAllow&) = delete;
+};
+
+inline void allocGuardCheck(std::size_t bytes) {
+    if (allocGuardDepth == 0 || allocGuardAllowed || allocGuardReporting) return;
+    allocGuardReporting = true;
+    char message[160];
+    std::snprintf(message, sizeof(message), "PokeBuddy: %zu-byte heap allocation during tick stage '%s'\n",
+        bytes, allocGuardStage ? allocGuardStage : "?");
+    if (allocGuardReport) allocGuardReport(message);
+    else std::fputs(message, stderr);
+    allocGuardReporting = false;
+}
+
+#define ALLOC_STAGE(name) (allocGuardStage = (name))
+
+void* operator new(std::size_t bytes) {
+    allocGuardCheck(bytes);
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t bytes) { return operator new(bytes); }
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept {
+    allocGuardCheck(bytes);
+    return std::malloc(bytes ? bytes : 1);
+}
+void* operator new[](std::size_t bytes, const std::nothrow_t& tag) noexcept { return operator new(bytes, tag); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#else
+
+struct AllocGuardScope { AllocGuardScope() {} };
+struct AllocGuardAllow { AllocGuardAllow() {} };
+#define ALLOC_STAGE(name) ((void)0)
+
+#endif
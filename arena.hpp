@@ -0,0 +1,110 @@
+#pragma once
+
+// Scratch memory for strings. Arena hands out memory by bumping a pointer
+// through large blocks and frees it all at once, for things that live as
+// long as the session (asset paths, item names). TextBuilder formats paths
+// and labels into a fixed buffer on the stack; what needs to outlive the
+// call is copied into an arena. Neither touches the heap per string.
+
+#include "utf8.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 4096) : blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        size_t start = (offset + align - 1) & ~(align - 1);
+        if (blocks.empty() || start + bytes > capacity) {
+            capacity = bytes > blockSize ? bytes : blockSize;
+            blocks.emplace_back(new char[capacity]);
+            start = 0;
+        }
+        offset = start + bytes;
+        return blocks.back().get() + start;
+    }
+
+    // NUL-terminated copy of n characters.
+    const wchar_t* copy(const wchar_t* s, size_t n) {
+        wchar_t* out = (wchar_t*)allocate((n + 1) * sizeof(wchar_t), alignof(wchar_t));
+        std::memcpy(out, s, n * sizeof(wchar_t));
+        out[n] = L'\0';
+        return out;
+    }
+
+    // Frees everything; the first block is kept for reuse.
+    void reset() {
+        if (blocks.size() > 1) blocks.resize(1);
+        capacity = blocks.empty() ? 0 : blockSize;
+        offset = 0;
+    }
+
+private:
+    size_t blockSize;
+    size_t capacity = 0;
+    size_t offset = 0;
+    std::vector<std::unique_ptr<char[]>> blocks;
+};
+
+// Fixed-size wide string builder. Text that does not fit is cut off and
+// flagged; the buffer is always NUL-terminated.
+template <size_t N>
+class TextBuilder {
+public:
+    TextBuilder() { text[0] = L'\0'; }
+
+    TextBuilder& operator<<(const wchar_t* s) {
+        while (*s) put(*s++);
+        return *this;
+    }
+
+    // UTF-8
+    TextBuilder& operator<<(const std::string& s) {
+        decodeUtf8(s.data(), s.size(), [this](wchar_t c) { put(c); });
+        return *this;
+    }
+
+    TextBuilder& operator<<(long long v) {
+        wchar_t digits[24];
+        int n = 0;
+        unsigned long long u = v < 0 ? 0ull - (unsigned long long)v : (unsigned long long)v;
+        do { digits[n++] = (wchar_t)(L'0' + u % 10); u /= 10; } while (u);
+        if (v < 0) put(L'-');
+        while (n) put(digits[--n]);
+        return *this;
+    }
+
+    TextBuilder& operator<<(int v) { return *this << (long long)v; }
+
+    const wchar_t* c_str() const { return text; }
+    wchar_t* data() { return text; }
+    size_t size() const { return length; }
+    bool truncated() const { return cut; }
+
+    const wchar_t* keep(Arena& arena) const { return arena.copy(text, length); }
+
+private:
+    void put(wchar_t c) {
+        if (length + 1 >= N) {
+            cut = true;
+            return;
+        }
+        text[length++] = c;
+        text[length] = L'\0';
+    }
+
+    wchar_t text[N];
+    size_t length = 0;
+    bool cut = false;
+};
+
+constexpr size_t maxPathLength = 260; // MAX_PATH
+using PathBuilder = TextBuilder<maxPathLength>;
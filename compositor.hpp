@@ -0,0 +1,116 @@
+#pragma once
+
+// Decides which pets share one layered window and which parts of that
+// window need repainting. The host does the drawing; everything here is
+// plain rectangle math so it can be checked without a desktop.
+
+#include "geometry.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A small set of screen rectangles that need repainting. Overlapping or
+// touching rects are merged as they arrive; once the set is full the new
+// rect joins whichever existing one grows the least.
+class DirtyRegion {
+public:
+    static constexpr size_t maxRects = 8;
+
+    void clear() { count = 0; }
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    const Bounds* begin() const { return rects; }
+    const Bounds* end() const { return rects + count; }
+
+    void add(Bounds r) {
+        if (r.empty()) return;
+        for (;;) {
+            // Absorb everything the rect touches; a grown rect may touch
+            // ones it missed, so start over after each merge.
+            bool merged = false;
+            for (size_t i = 0; i < count; ++i) {
+                if (rects[i].contains(r)) return;
+                if (touches(rects[i], r)) {
+                    r = unite(r, rects[i]);
+                    rects[i] = rects[--count];
+                    merged = true;
+                    break;
+                }
+            }
+            if (merged) continue;
+            if (count < maxRects) break;
+
+            size_t best = 0;
+            long long bestGrowth = -1;
+            for (size_t i = 0; i < count; ++i) {
+                long long growth = unite(rects[i], r).area() - rects[i].area();
+                if (bestGrowth < 0 || growth < bestGrowth) {
+                    best = i;
+                    bestGrowth = growth;
+                }
+            }
+            r = unite(r, rects[best]);
+            rects[best] = rects[--count];
+        }
+        rects[count++] = r;
+    }
+
+    Bounds bounds() const {
+        Bounds all;
+        for (size_t i = 0; i < count; ++i) all = unite(all, rects[i]);
+        return all;
+    }
+
+private:
+    Bounds rects[maxRects];
+    size_t count = 0;
+};
+
+struct CompositionPlan {
+    bool shared = false;
+    Bounds surface;               // where the shared window sits
+    std::vector<uint8_t> inShared; // per pet: drawn into the shared window
+};
+
+// Pets overlapping `region` (the taskbar strip) share one window while they
+// are close together. When their bounding box is mostly empty space one
+// window per pet is cheaper, so the plan falls back. Separate enter/leave
+// ratios keep the plan from flapping at the threshold.
+class CompositionPlanner {
+public:
+    int surfacePadding = 32;  // slack so walking pets don't resize the surface every step
+    long long enterRatio = 3; // cluster area / pet area to start sharing
+    long long leaveRatio = 6; // ... and to stop
+
+    // Returns true when the surface moved or resized.
+    bool plan(const Bounds* pets, size_t count, const Bounds& region, CompositionPlan& out) const {
+        out.inShared.assign(count, 0);
+
+        Bounds cluster;
+        long long petArea = 0;
+        size_t members = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (!intersects(pets[i], region)) continue;
+            out.inShared[i] = 1;
+            cluster = unite(cluster, pets[i]);
+            petArea += pets[i].area();
+            ++members;
+        }
+
+        long long limit = out.shared ? leaveRatio : enterRatio;
+        if (members < 2 || cluster.area() > petArea * limit) {
+            out.inShared.assign(count, 0);
+            bool changed = out.shared;
+            out.shared = false;
+            out.surface = Bounds{};
+            return changed;
+        }
+
+        out.shared = true;
+        if (out.surface.contains(cluster) && inflate(cluster, 2 * surfacePadding).contains(out.surface))
+            return false;
+        out.surface = inflate(cluster, surfacePadding);
+        return true;
+    }
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+// Cached monitor and taskbar layout. The host fills it from the OS when the
+// display or work area changes; everything per tick (walk limits, where
+// pets share a window) reads the cache. Portable so layouts can be made up.
+
+#include "geometry.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+struct MonitorArea {
+    Bounds monitor;
+    Bounds work;
+    bool primary = false;
+};
+
+class DisplayGeometry {
+public:
+    void setLayout(std::vector<MonitorArea> layout, const Bounds& taskbarRect) {
+        monitors = std::move(layout);
+        taskbar = taskbarRect;
+    }
+
+    bool empty() const { return monitors.empty(); }
+    const std::vector<MonitorArea>& layout() const { return monitors; }
+    const Bounds& taskbarBounds() const { return taskbar; }
+
+    // Monitor containing the point, else the closest one; -1 with no monitors.
+    int monitorAt(int x, int y) const {
+        int best = -1;
+        long long bestDistance = 0;
+        for (size_t i = 0; i < monitors.size(); ++i) {
+            const Bounds& m = monitors[i].monitor;
+            if (m.contains(x, y)) return (int)i;
+            long long dx = x < m.left ? m.left - x : (x >= m.right ? x - m.right + 1 : 0);
+            long long dy = y < m.top ? m.top - y : (y >= m.bottom ? y - m.bottom + 1 : 0);
+            long long distance = dx * dx + dy * dy;
+            if (best < 0 || distance < bestDistance) {
+                best = (int)i;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    const MonitorArea* primaryMonitor() const {
+        for (const MonitorArea& m : monitors)
+            if (m.primary) return &m;
+        return monitors.empty() ? nullptr : &monitors[0];
+    }
+
+    // Pets may roam the whole monitor they stand on; the taskbar is part of
+    // the floor, so this is the monitor rect rather than the work area.
+    Bounds walkArea(const Bounds& pet) const {
+        int m = monitorAt(pet.left + pet.width() / 2, pet.top + pet.height() / 2);
+        return m < 0 ? Bounds{} : monitors[m].monitor;
+    }
+
+    // Moves a pet rect fully onto the nearest monitor (after a monitor was
+    // unplugged, or a save came from a bigger desktop).
+    Bounds keepOnScreen(const Bounds& pet) const {
+        Bounds area = walkArea(pet);
+        if (area.empty()) return pet;
+        int dx = 0, dy = 0;
+        if (pet.right > area.right) dx = area.right - pet.right;
+        if (pet.left + dx < area.left) dx = area.left - pet.left;
+        if (pet.bottom > area.bottom) dy = area.bottom - pet.bottom;
+        if (pet.top + dy < area.top) dy = area.top - pet.top;
+        return { pet.left + dx, pet.top + dy, pet.right + dx, pet.bottom + dy };
+    }
+
+    // Where a new pet sits: on the taskbar near its right end, or at the
+    // bottom right of the primary monitor when there is no taskbar.
+    Bounds restingSpot(int width, int height) const {
+        Bounds floor = taskbar;
+        if (floor.empty()) {
+            const MonitorArea* m = primaryMonitor();
+            if (!m) return boundsAt(0, 0, width, height);
+            floor = m->monitor;
+        }
+        return boundsAt(floor.right - width - 80, floor.bottom - height + 2, width, height);
+    }
+
+    // The band pets stand in along the taskbar, for the shared surface.
+    Bounds taskbarStrip(int petHeight) const {
+        Bounds floor = taskbar;
+        if (floor.empty()) {
+            const MonitorArea* m = primaryMonitor();
+            if (!m) return Bounds{};
+            floor = { m->monitor.left, m->monitor.bottom - petHeight, m->monitor.right, m->monitor.bottom };
+        }
+        return { floor.left, floor.top - petHeight, floor.right, floor.bottom };
+    }
+
+private:
+    std::vector<MonitorArea> monitors;
+    Bounds taskbar;
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+// Map on a sorted vector, for use as the ObjectType of a basic_json. Keys
+// are found by binary search over one contiguous block instead of a walk
+// through red-black tree nodes, and iteration is in key order like
+// std::map, so documents dump the same. Parsing and saving insert keys in
+// order, which appends. The first insert reserves room for a small object's
+// keys, so objects of up to smallObjectCapacity keys take one allocation.
+//
+// Insertion and erasure move entries and invalidate iterators and
+// references into the map, as with std::vector.
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+constexpr size_t smallObjectCapacity = 8;
+
+template <typename Key, typename T, typename Compare = std::less<>,
+    typename Allocator = std::allocator<std::pair<const Key, T>>>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    using container_type = std::vector<value_type, allocator_type>;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using reverse_iterator = typename container_type::reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+
+    FlatMap() = default;
+    explicit FlatMap(const Allocator& alloc) : entries(allocator_type(alloc)) {}
+    template <typename InputIt>
+    FlatMap(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : entries(allocator_type(alloc)) {
+        insert(first, last);
+    }
+    FlatMap(std::initializer_list<value_type> init, const Allocator& alloc = Allocator())
+        : FlatMap(init.begin(), init.end(), alloc) {}
+
+    iterator begin() noexcept { return entries.begin(); }
+    const_iterator begin() const noexcept { return entries.begin(); }
+    const_iterator cbegin() const noexcept { return entries.cbegin(); }
+    iterator end() noexcept { return entries.end(); }
+    const_iterator end() const noexcept { return entries.end(); }
+    const_iterator cend() const noexcept { return entries.cend(); }
+    reverse_iterator rbegin() noexcept { return entries.rbegin(); }
+    const_reverse_iterator rbegin() const noexcept { return entries.rbegin(); }
+    reverse_iterator rend() noexcept { return entries.rend(); }
+    const_reverse_iterator rend() const noexcept { return entries.rend(); }
+
+    bool empty() const noexcept { return entries.empty(); }
+    size_type size() const noexcept { return entries.size(); }
+    size_type max_size() const noexcept { return entries.max_size(); }
+    void clear() noexcept { entries.clear(); }
+    void reserve(size_type n) { entries.reserve(n); }
+
+    // Small objects are scanned: comparing for equality rejects most keys
+    // on their length, where a binary search compares characters.
+    template <typename K>
+    iterator find(const K& key) {
+        if (entries.size() <= smallObjectCapacity)
+            return std::find_if(entries.begin(), entries.end(), [&key](const value_type& entry) { return entry.first == key; });
+        iterator it = position(key);
+        return it != entries.end() && !compare(key, it->first) ? it : entries.end();
+    }
+    template <typename K>
+    const_iterator find(const K& key) const {
+        if (entries.size() <= smallObjectCapacity)
+            return std::find_if(entries.begin(), entries.end(), [&key](const value_type& entry) { return entry.first == key; });
+        const_iterator it = position(key);
+        return it != entries.end() && !compare(key, it->first) ? it : entries.end();
+    }
+    template <typename K>
+    size_type count(const K& key) const { return find(key) != end() ? 1 : 0; }
+
+    template <typename K>
+    T& at(const K& key) {
+        iterator it = find(key);
+        if (it == end()) throw std::out_of_range("key not found");
+        return it->second;
+    }
+    template <typename K>
+    const T& at(const K& key) const {
+        const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("key not found");
+        return it->second;
+    }
+
+    template <typename K>
+    T& operator[](K&& key) { return emplace(std::forward<K>(key)).first->second; }
+
+    // Constructs the value from args unless the key is already present.
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+        if (entries.capacity() == 0) entries.reserve(smallObjectCapacity);
+        iterator it = entries.empty() || compare(entries.back().first, key) ? entries.end() : position(key);
+        if (it != entries.end() && !compare(key, it->first)) return { it, false };
+        it = entries.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        return { it, true };
+    }
+
+    template <typename P, typename = typename std::enable_if<std::is_constructible<value_type, P&&>::value>::type>
+    std::pair<iterator, bool> insert(P&& value) {
+        return emplace(std::forward<P>(value).first, std::forward<P>(value).second);
+    }
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) emplace(first->first, first->second);
+    }
+
+    iterator erase(const_iterator pos) { return entries.erase(pos); }
+    iterator erase(const_iterator first, const_iterator last) { return entries.erase(first, last); }
+    template <typename K, typename = typename std::enable_if<!std::is_convertible<K, const_iterator>::value>::type>
+    size_type erase(const K& key) {
+        iterator it = find(key);
+        if (it == end()) return 0;
+        entries.erase(it);
+        return 1;
+    }
+
+    friend bool operator==(const FlatMap& a, const FlatMap& b) { return a.entries == b.entries; }
+    friend bool operator!=(const FlatMap& a, const FlatMap& b) { return a.entries != b.entries; }
+    friend bool operator<(const FlatMap& a, const FlatMap& b) { return a.entries < b.entries; }
+    friend bool operator<=(const FlatMap& a, const FlatMap& b) { return a.entries <= b.entries; }
+    friend bool operator>(const FlatMap& a, const FlatMap& b) { return a.entries > b.entries; }
+    friend bool operator>=(const FlatMap& a, const FlatMap& b) { return a.entries >= b.entries; }
+
+private:
+    // First entry whose key is not less than `key`.
+    template <typename K>
+    iterator position(const K& key) {
+        return std::lower_bound(entries.begin(), entries.end(), key,
+            [this](const value_type& entry, const K& k) { return compare(entry.first, k); });
+    }
+    template <typename K>
+    const_iterator position(const K& key) const {
+        return std::lower_bound(entries.begin(), entries.end(), key,
+            [this](const value_type& entry, const K& k) { return compare(entry.first, k); });
+    }
+
+    container_type entries;
+    Compare compare;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+// Owning wrappers for the GDI and GDI+ objects the host creates, so
+// nothing depends on a matching delete/DeleteDC/DeleteObject being reached.
+// Building with POKEBUDDY_HANDLE_TRACKING counts the live objects of each
+// kind; reportLiveHandles() logs them (with the process' GDI object count)
+// so growth over a long uptime shows up in a debugger or DebugView.
+//
+// Every GDI+ owner must be empty before GdiplusShutdown.
+
+#include <windows.h>
+#include <gdiplus.h>
+
+#include <cstdio>
+
+enum HandleKind {
+    HANDLE_IMAGE,    // Gdiplus::Image and Bitmap
+    HANDLE_GRAPHICS,
+    HANDLE_DC,
+    HANDLE_BITMAP,   // HBITMAP
+    HANDLE_KIND_COUNT
+};
+
+#ifdef POKEBUDDY_HANDLE_TRACKING
+inline int liveHandles[HANDLE_KIND_COUNT] = {};
+inline void trackHandle(HandleKind kind, int delta) { liveHandles[kind] += delta; }
+
+inline void reportLiveHandles() {
+    char message[160];
+    std::snprintf(message, sizeof(message),
+        "PokeBuddy: live images=%d graphics=%d dcs=%d bitmaps=%d, process GDI objects=%lu\n",
+        liveHandles[HANDLE_IMAGE], liveHandles[HANDLE_GRAPHICS], liveHandles[HANDLE_DC],
+        liveHandles[HANDLE_BITMAP], (unsigned long)GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS));
+    OutputDebugStringA(message);
+}
+#else
+inline void trackHandle(HandleKind, int) {}
+inline void reportLiveHandles() {}
+#endif
+
+// Owns one GDI+ object (they are allocated by GDI+'s own operator new).
+template <typename T, HandleKind Kind>
+class GdiplusPtr {
+public:
+    GdiplusPtr() = default;
+    explicit GdiplusPtr(T* p) { reset(p); }
+    ~GdiplusPtr() { reset(); }
+
+    GdiplusPtr(GdiplusPtr&& other) noexcept : p(other.p) { other.p = nullptr; }
+    GdiplusPtr& operator=(GdiplusPtr&& other) noexcept {
+        if (this != &other) {
+            reset();
+            p = other.p;
+            other.p = nullptr;
+        }
+        return *this;
+    }
+    GdiplusPtr(const GdiplusPtr&) = delete;
+    GdiplusPtr& operator=(const GdiplusPtr&) = delete;
+
+    void reset(T* next = nullptr) {
+        if (p) {
+            delete p;
+            trackHandle(Kind, -1);
+        }
+        p = next;
+        if (p) trackHandle(Kind, +1);
+    }
+
+    T* get() const { return p; }
+    T* operator->() const { return p; }
+    T& operator*() const { return *p; }
+    explicit operator bool() const { return p != nullptr; }
+
+private:
+    T* p = nullptr;
+};
+
+using ImagePtr = GdiplusPtr<Gdiplus::Image, HANDLE_IMAGE>;
+using BitmapPtr = GdiplusPtr<Gdiplus::Bitmap, HANDLE_IMAGE>;
+using GraphicsPtr = GdiplusPtr<Gdiplus::Graphics, HANDLE_GRAPHICS>;
+
+// Image::FromFile that owns the result and drops images that failed to load.
+inline ImagePtr loadImage(const wchar_t* path) {
+    ImagePtr image(Gdiplus::Image::FromFile(path));
+    if (image && image->GetLastStatus() != Gdiplus::Ok) image.reset();
+    return image;
+}
+
+class GdiBitmap {
+public:
+    GdiBitmap() = default;
+    ~GdiBitmap() { reset(); }
+    GdiBitmap(const GdiBitmap&) = delete;
+    GdiBitmap& operator=(const GdiBitmap&) = delete;
+
+    void reset(HBITMAP next = NULL) {
+        if (bmp) {
+            DeleteObject(bmp);
+            trackHandle(HANDLE_BITMAP, -1);
+        }
+        bmp = next;
+        if (bmp) trackHandle(HANDLE_BITMAP, +1);
+    }
+
+    HBITMAP get() const { return bmp; }
+    explicit operator bool() const { return bmp != NULL; }
+
+private:
+    HBITMAP bmp = NULL;
+};
+
+// A memory DC compatible with the screen. Whatever was selected into it
+// is put back before the DC is deleted, so the bitmap can be freed after.
+class MemoryDC {
+public:
+    MemoryDC() = default;
+    ~MemoryDC() { reset(); }
+    MemoryDC(const MemoryDC&) = delete;
+    MemoryDC& operator=(const MemoryDC&) = delete;
+
+    void create() {
+        reset();
+        dc = CreateCompatibleDC(NULL);
+        if (dc) trackHandle(HANDLE_DC, +1);
+    }
+
+    void select(HGDIOBJ obj) {
+        HGDIOBJ previous = SelectObject(dc, obj);
+        if (!original) original = previous;
+    }
+
+    void reset() {
+        if (!dc) return;
+        if (original) SelectObject(dc, original);
+        DeleteDC(dc);
+        trackHandle(HANDLE_DC, -1);
+        dc = NULL;
+        original = NULL;
+    }
+
+    HDC get() const { return dc; }
+    explicit operator bool() const { return dc != NULL; }
+
+private:
+    HDC dc = NULL;
+    HGDIOBJ original = NULL;
+};
+
+// GetDC/ReleaseDC for the screen, scoped.
+class ScreenDC {
+public:
+    ScreenDC() : dc(GetDC(NULL)) {}
+    ~ScreenDC() { ReleaseDC(NULL, dc); }
+    ScreenDC(const ScreenDC&) = delete;
+    ScreenDC& operator=(const ScreenDC&) = delete;
+
+    HDC get() const { return dc; }
+
+private:
+    HDC dc;
+};
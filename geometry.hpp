@@ -0,0 +1,56 @@
+#pragma once
+
+// Screen-space rectangles for the portable modules. Same convention as a
+// Win32 RECT: left/top inclusive, right/bottom exclusive.
+
+#include <algorithm>
+
+struct Bounds {
+    int left = 0, top = 0, right = 0, bottom = 0;
+
+    int width() const { return right - left; }
+    int height() const { return bottom - top; }
+    bool empty() const { return right <= left || bottom <= top; }
+    long long area() const { return empty() ? 0 : (long long)width() * height(); }
+
+    bool contains(int x, int y) const { return x >= left && x < right && y >= top && y < bottom; }
+    bool contains(const Bounds& b) const {
+        return b.left >= left && b.top >= top && b.right <= right && b.bottom <= bottom;
+    }
+};
+
+inline bool operator==(const Bounds& a, const Bounds& b) {
+    return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+inline bool operator!=(const Bounds& a, const Bounds& b) { return !(a == b); }
+
+inline Bounds boundsAt(int x, int y, int width, int height) {
+    return { x, y, x + width, y + height };
+}
+
+inline bool intersects(const Bounds& a, const Bounds& b) {
+    return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+// Overlapping or sharing an edge.
+inline bool touches(const Bounds& a, const Bounds& b) {
+    return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+}
+
+inline Bounds unite(const Bounds& a, const Bounds& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return { (std::min)(a.left, b.left), (std::min)(a.top, b.top),
+             (std::max)(a.right, b.right), (std::max)(a.bottom, b.bottom) };
+}
+
+inline Bounds intersect(const Bounds& a, const Bounds& b) {
+    Bounds r{ (std::max)(a.left, b.left), (std::max)(a.top, b.top),
+              (std::min)(a.right, b.right), (std::min)(a.bottom, b.bottom) };
+    return r.empty() ? Bounds{} : r;
+}
+
+inline Bounds inflate(const Bounds& b, int by) {
+    return { b.left - by, b.top - by, b.right + by, b.bottom + by };
+}
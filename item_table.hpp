@@ -0,0 +1,124 @@
+#pragma once
+
+// Everything the UI needs to know about an item, worked out once when the
+// item is first seen (at startup for the known items and the saved bag)
+// instead of every time a label or path is wanted. All wide strings live
+// back to back in one arena, so lookups are an index and nothing more.
+// Item keys are decoded as UTF-8 rather than widened byte by byte. Keys
+// read from the save file go through internSaved(), which turns away
+// anything that is not a plain file name.
+
+#include "arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cwctype>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum ItemCategory : uint8_t {
+    ITEM_BERRY,
+    ITEM_BALL,
+    ITEM_OTHER
+};
+
+// Items a pet can find while exploring; they are always ids 0..count-1.
+constexpr const char* foundItemKeys[] = { "oran-berry", "sitrus-berry", "pecha-berry", "pokeball" };
+constexpr int foundItemCount = sizeof(foundItemKeys) / sizeof(foundItemKeys[0]);
+
+// Most rows the table grows to from a save, found items included; the rest
+// of a hand-edited bag is dropped rather than growing it without bound.
+constexpr int maxItemKinds = 256;
+
+// A key that is safe as a file name under assets\berries: lowercase
+// letters, digits, '-' and '_', so no separators, dots or drive letters.
+inline bool isItemKey(const std::string& key) {
+    if (key.empty() || key.size() > 32) return false;
+    for (char c : key)
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_')) return false;
+    return true;
+}
+
+class ItemTable {
+public:
+    ItemTable() {
+        for (const char* key : foundItemKeys) intern(key);
+    }
+
+    int size() const { return (int)rows.size(); }
+
+    int find(const std::string& key) const {
+        auto it = ids.find(key);
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    // Id for `key`, adding a row the first time it is seen.
+    int intern(const std::string& key) {
+        int id = find(key);
+        if (id >= 0) return id;
+
+        Row row;
+        row.key = key;
+        row.category = categoryOf(key);
+
+        // "sitrus-berry" -> "Sitrus berry"
+        TextBuilder<64> name;
+        name << key;
+        wchar_t* c = name.data();
+        for (size_t i = 0; i < name.size(); ++i)
+            if (c[i] == L'-') c[i] = L' ';
+        if (name.size()) c[0] = (wchar_t)towupper(c[0]);
+        row.name = name.keep(text);
+
+        PathBuilder icon, eatAnim;
+        icon << L"assets\\berries\\" << key << L".png";
+        eatAnim << L"assets\\berries\\" << key << L"-eat.gif";
+        row.icon = icon.keep(text);
+        row.eatAnim = eatAnim.keep(text);
+
+        id = (int)rows.size();
+        rows.push_back(row);
+        ids.emplace(key, id);
+        return id;
+    }
+
+    // Id for a key read from the save file, or -1 if it is not a plain
+    // name or would take the table past maxItemKinds.
+    int internSaved(const std::string& key) {
+        if (!isItemKey(key)) return -1;
+        int id = find(key);
+        if (id >= 0) return id;
+        return size() < maxItemKinds ? intern(key) : -1;
+    }
+
+    const std::string& key(int id) const { return rows[id].key; }
+    ItemCategory category(int id) const { return rows[id].category; }
+    const wchar_t* displayName(int id) const { return rows[id].name; }
+    const wchar_t* iconPath(int id) const { return rows[id].icon; }
+    const wchar_t* eatAnimPath(int id) const { return rows[id].eatAnim; }
+
+private:
+    struct Row {
+        std::string key;
+        const wchar_t* name = nullptr; // all three point into `text`
+        const wchar_t* icon = nullptr;
+        const wchar_t* eatAnim = nullptr;
+        ItemCategory category = ITEM_OTHER;
+    };
+
+    static bool endsWith(const std::string& s, const char* suffix) {
+        size_t n = std::char_traits<char>::length(suffix);
+        return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+    }
+
+    static ItemCategory categoryOf(const std::string& key) {
+        if (endsWith(key, "-berry")) return ITEM_BERRY;
+        if (endsWith(key, "ball")) return ITEM_BALL;
+        return ITEM_OTHER;
+    }
+
+    std::vector<Row> rows;
+    std::unordered_map<std::string, int> ids; // key -> index into rows
+    Arena text;
+};
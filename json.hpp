@@ -6706,6 +6706,23 @@ class iterator_input_adapter
         return count * sizeof(T);
     }
 
+    // direct access for contiguous byte ranges (see is_contiguous_byte_input);
+    // only instantiated when IteratorType is a pointer
+    IteratorType data() const noexcept
+    {
+        return current;
+    }
+
+    std::size_t remaining() const noexcept
+    {
+        return static_cast<std::size_t>(end - current);
+    }
+
+    void skip(std::size_t count) noexcept
+    {
+        current += count;
+    }
+
   private:
     IteratorType current;
     IteratorType end;
@@ -6719,6 +6736,15 @@ class iterator_input_adapter
     }
 };
 
+/// whether an input adapter reads a contiguous range of bytes, which lets the
+/// lexer scan ahead in bulk instead of one get_character() call per byte
+template<typename InputAdapterType>
+struct is_contiguous_byte_input : std::false_type {};
+
+template<typename CharT>
+struct is_contiguous_byte_input<iterator_input_adapter<CharT*>>
+    : std::integral_constant < bool, std::is_integral<CharT>::value && sizeof(CharT) == 1 > {};
+
 template<typename BaseInputAdapter, size_t T>
 struct wide_string_input_helper;
 
@@ -6952,9 +6978,38 @@ using std::end;
 template<typename ContainerType, typename Enable = void>
 struct container_input_adapter_factory {};
 
+/// whether a container holds its bytes contiguously (std::string, std::vector<char>,
+/// std::array<std::uint8_t, N>, ...), so it can be read as a pointer range
+template<typename ContainerType, typename Enable = void>
+struct is_contiguous_byte_container : std::false_type {};
+
+template<typename ContainerType>
+struct is_contiguous_byte_container < ContainerType,
+       void_t<decltype(std::declval<const ContainerType&>().data()), decltype(std::declval<const ContainerType&>().size())> >
+{
+    using data_type = decltype(std::declval<const ContainerType&>().data());
+    using char_type = typename std::remove_cv<typename std::remove_pointer<data_type>::type>::type;
+
+    static constexpr bool value = std::is_pointer<data_type>::value && std::is_integral<char_type>::value && sizeof(char_type) == 1;
+};
+
+template<typename ContainerType>
+struct container_input_adapter_factory < ContainerType,
+       enable_if_t<is_contiguous_byte_container<ContainerType>::value> >
+{
+    using pointer_type = decltype(std::declval<const ContainerType&>().data());
+    using adapter_type = decltype(input_adapter(std::declval<pointer_type>(), std::declval<pointer_type>()));
+
+    static adapter_type create(const ContainerType& container)
+    {
+        return input_adapter(container.data(), container.data() + container.size());
+    }
+};
+
 template<typename ContainerType>
 struct container_input_adapter_factory< ContainerType,
-       void_t<decltype(begin(std::declval<ContainerType>()), end(std::declval<ContainerType>()))>>
+       void_t<decltype(begin(std::declval<ContainerType>()), end(std::declval<ContainerType>())),
+       enable_if_t<!is_contiguous_byte_container<ContainerType>::value>>>
        {
            using adapter_type = decltype(input_adapter(begin(std::declval<ContainerType>()), end(std::declval<ContainerType>())));
 
@@ -7089,15 +7144,31 @@ NLOHMANN_JSON_NAMESPACE_END
 
 
 #include <array> // array
+#include <cfloat> // FLT_EVAL_METHOD
 #include <clocale> // localeconv
 #include <cstddef> // size_t
+#include <cstdint> // uint64_t
 #include <cstdio> // snprintf
 #include <cstdlib> // strtof, strtod, strtold, strtoll, strtoull
 #include <initializer_list> // initializer_list
 #include <string> // char_traits, string
+#include <type_traits> // integral_constant
 #include <utility> // move
 #include <vector> // vector
 
+// SSE2 is part of every x86-64 target; define JSON_NO_SIMD to use the
+// portable scalar loop instead
+#if !defined(JSON_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include <emmintrin.h> // _mm_loadu_si128, _mm_cmpgt_epi8, _mm_movemask_epi8
+    #define JSON_USE_SSE2 1
+#endif
+
+// the exact float fast path relies on double arithmetic being rounded to
+// double (not carried in x87 extended precision)
+#if (defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0) || defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64)
+    #define JSON_EXACT_DOUBLE_ARITHMETIC 1
+#endif
+
 // #include <nlohmann/detail/input/input_adapters.hpp>
 
 // #include <nlohmann/detail/input/position_t.hpp>
@@ -7111,6 +7182,54 @@ NLOHMANN_JSON_NAMESPACE_BEGIN
 namespace detail
 {
 
+/*!
+@brief length of the leading run of bytes that a string can copy verbatim
+
+Stops at the first quote, backslash, control character or non-ASCII byte
+(which needs UTF-8 validation), and at DEL if @a stop_at_del is set: i.e. at
+everything lexer::scan_string() and serializer::dump_escaped() must look at
+one byte at a time.
+*/
+inline std::size_t plain_ascii_run(const char* p, std::size_t n, bool stop_at_del) noexcept
+{
+    std::size_t i = 0;
+#ifdef JSON_USE_SSE2
+    // as signed bytes, 0x20..0x7F are exactly the values greater than 0x1F
+    const __m128i min_plain = _mm_set1_epi8(0x1F);
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    // when DEL may pass, this just repeats the quote comparison
+    const __m128i del = _mm_set1_epi8(stop_at_del ? 0x7F : '\"');
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                             _mm_cmpeq_epi8(v, del));
+        const __m128i plain = _mm_andnot_si128(special, _mm_cmpgt_epi8(v, min_plain));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(plain)) ^ 0xFFFFu;
+        if (mask != 0)
+        {
+            unsigned bit = 0;
+            while ((mask & (1u << bit)) == 0)
+            {
+                ++bit;
+            }
+            return i + bit;
+        }
+    }
+#endif
+    const unsigned end = stop_at_del ? 0x7F : 0x80;
+    for (; i < n; ++i)
+    {
+        const auto c = static_cast<unsigned char>(p[i]);
+        if (c < 0x20 || c >= end || c == '\"' || c == '\\')
+        {
+            break;
+        }
+    }
+    return i;
+}
+
 ///////////
 // lexer //
 ///////////
@@ -7209,7 +7328,9 @@ class lexer : public lexer_base<BasicJsonType>
         : ia(std::move(adapter))
         , ignore_comments(ignore_comments_)
         , decimal_point_char(static_cast<char_int_type>(get_decimal_point()))
-    {}
+    {
+        mark_token_start(is_contiguous_byte_input<InputAdapterType> {});
+    }
 
     // deleted because of pointer members
     lexer(const lexer&) = delete;
@@ -7321,6 +7442,57 @@ class lexer : public lexer_base<BasicJsonType>
         return true;
     }
 
+    /// copy the plain run at the read position in one go (contiguous input)
+    void scan_string_run(std::true_type)
+    {
+        if (next_unget)
+        {
+            return;
+        }
+        const auto* p = reinterpret_cast<const char*>(ia.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        const std::size_t n = plain_ascii_run(p, ia.remaining(), false);
+        if (n == 0)
+        {
+            return;
+        }
+        if (!token_in_input)
+        {
+            token_buffer.append(p, n);
+        }
+        // the run holds no newlines, so only the column moves
+        position.chars_read_total += n;
+        position.chars_read_current_line += n;
+        current = char_traits<char_type>::to_int_type(ia.data()[n - 1]);
+        ia.skip(n);
+    }
+
+    /// other inputs are read one character at a time
+    void scan_string_run(std::false_type) noexcept {}
+
+    /// the string read so far, between the opening quote and the last character read
+    std::pair<const char*, std::size_t> string_in_input(std::true_type) const noexcept
+    {
+        const auto* first = reinterpret_cast<const char*>(token_start) + 1; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* last = reinterpret_cast<const char*>(ia.data()) - 1; // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        return {first, static_cast<std::size_t>(last - first)};
+    }
+
+    std::pair<const char*, std::size_t> string_in_input(std::false_type) const noexcept
+    {
+        return {nullptr, 0};
+    }
+
+    /// copy a string still kept in the input into token_buffer
+    void materialize_string()
+    {
+        if (token_in_input)
+        {
+            const auto view = string_in_input(is_contiguous_byte_input<InputAdapterType> {});
+            token_buffer.assign(view.first, view.second);
+            token_in_input = false;
+        }
+    }
+
     /*!
     @brief scan a string literal
 
@@ -7330,6 +7502,9 @@ class lexer : public lexer_base<BasicJsonType>
     may contain \0 bytes), and token_buffer.size() is the number of bytes in the
     string.
 
+    A contiguous input already holds the string unless it has escapes, so
+    nothing is copied until the first backslash (see get_string_view).
+
     @return token_type::value_string if string could be successfully scanned,
             token_type::parse_error otherwise
 
@@ -7340,12 +7515,16 @@ class lexer : public lexer_base<BasicJsonType>
     {
         // reset token_buffer (ignore opening quote)
         reset();
+        token_in_input = is_contiguous_byte_input<InputAdapterType>::value;
 
         // we entered the function by reading an open quote
         JSON_ASSERT(current == '\"');
 
         while (true)
         {
+            // take plain ASCII in bulk where the input allows it
+            scan_string_run(is_contiguous_byte_input<InputAdapterType> {});
+
             // get the next character
             switch (get())
             {
@@ -7365,6 +7544,7 @@ class lexer : public lexer_base<BasicJsonType>
                 // escapes
                 case '\\':
                 {
+                    materialize_string();
                     switch (get())
                     {
                         // quotation mark
@@ -8011,6 +8191,96 @@ class lexer : public lexer_base<BasicJsonType>
         f = std::strtold(str, endptr);
     }
 
+    /// add a digit to the significand collected by scan_number(); leading
+    /// zeros are not counted, so digits <= 19 means no overflow
+    static void add_significand_digit(std::uint64_t& significand, std::size_t& digits, char_int_type c) noexcept
+    {
+        significand = significand * 10 + static_cast<std::uint64_t>(c - '0');
+        digits += static_cast<std::size_t>(digits != 0 || c != '0');
+    }
+
+    /// add a digit to the exponent collected by scan_number(); saturates far
+    /// beyond any exponent the fast path accepts
+    static void add_exponent_digit(int& exponent, char_int_type c) noexcept
+    {
+        if (exponent < 100000)
+        {
+            exponent = exponent * 10 + static_cast<int>(c - '0');
+        }
+    }
+
+    /*!
+    @brief convert significand * 10^exponent without going through strtod
+
+    Clinger's fast path: a significand of at most 53 bits and a power of ten
+    up to 1e22 are both exact doubles, so a single multiplication or division
+    is correctly rounded and matches strtod bit for bit. Larger exponents are
+    taken while the excess still fits into the significand exactly. Returns
+    false for everything else, which is left to strtod.
+    */
+    static bool exact_float(double& f, std::uint64_t significand, std::size_t digits,
+                            long long exponent, bool negative) noexcept
+    {
+#ifdef JSON_EXACT_DOUBLE_ARITHMETIC
+        static constexpr std::array<double, 23> powers_of_ten =
+        {
+            {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            }
+        };
+        constexpr std::uint64_t max_exact = std::uint64_t(1) << 53;
+
+        if (digits > 19 || significand > max_exact)
+        {
+            return false;
+        }
+
+        double value = static_cast<double>(significand);
+        if (significand != 0)
+        {
+            if (exponent < 0)
+            {
+                if (exponent < -22)
+                {
+                    return false;
+                }
+                value /= powers_of_ten[static_cast<std::size_t>(-exponent)];
+            }
+            else
+            {
+                for (; exponent > 22; --exponent)
+                {
+                    if (significand > max_exact / 10)
+                    {
+                        return false;
+                    }
+                    significand *= 10;
+                }
+                value = static_cast<double>(significand) * powers_of_ten[static_cast<std::size_t>(exponent)];
+            }
+        }
+
+        f = negative ? -value : value;
+        return true;
+#else
+        static_cast<void>(f);
+        static_cast<void>(significand);
+        static_cast<void>(digits);
+        static_cast<void>(exponent);
+        static_cast<void>(negative);
+        return false;
+#endif
+    }
+
+    /// float and long double numbers always go through strtof/strtold
+    template<typename FloatType>
+    static bool exact_float(FloatType& /*f*/, std::uint64_t /*significand*/, std::size_t /*digits*/,
+                            long long /*exponent*/, bool /*negative*/) noexcept
+    {
+        return false;
+    }
+
     /*!
     @brief scan a number literal
 
@@ -8041,7 +8311,10 @@ class lexer : public lexer_base<BasicJsonType>
 
     During scanning, the read bytes are stored in token_buffer. This string is
     then converted to a signed integer, an unsigned integer, or a
-    floating-point number.
+    floating-point number. The digits are also collected into an integer
+    significand and a decimal exponent on the way, which converts integers
+    of up to 18/19 digits and most floats (see exact_float) directly; the
+    rest goes through strtoull, strtoll, and strtod.
 
     @return token_type::value_unsigned, token_type::value_integer, or
             token_type::value_float if number could be successfully scanned,
@@ -8060,6 +8333,14 @@ class lexer : public lexer_base<BasicJsonType>
         // changed if minus sign, decimal point, or exponent is read
         token_type number_type = token_type::value_unsigned;
 
+        // the digits without the decimal point, the number of fraction digits,
+        // and the exponent, collected on the way for the fast conversions
+        std::uint64_t significand = 0;
+        std::size_t significand_digits = 0;
+        std::size_t fraction_digits = 0;
+        int exponent = 0;
+        bool exponent_negative = false;
+
         // state (init): we just found out we need to scan a number
         switch (current)
         {
@@ -8086,6 +8367,7 @@ class lexer : public lexer_base<BasicJsonType>
             case '9':
             {
                 add(current);
+                add_significand_digit(significand, significand_digits, current);
                 goto scan_number_any1;
             }
 
@@ -8116,6 +8398,7 @@ scan_number_minus:
             case '9':
             {
                 add(current);
+                add_significand_digit(significand, significand_digits, current);
                 goto scan_number_any1;
             }
 
@@ -8164,6 +8447,7 @@ scan_number_any1:
             case '9':
             {
                 add(current);
+                add_significand_digit(significand, significand_digits, current);
                 goto scan_number_any1;
             }
 
@@ -8202,6 +8486,8 @@ scan_number_decimal1:
             case '9':
             {
                 add(current);
+                add_significand_digit(significand, significand_digits, current);
+                ++fraction_digits;
                 goto scan_number_decimal2;
             }
 
@@ -8228,6 +8514,8 @@ scan_number_decimal2:
             case '9':
             {
                 add(current);
+                add_significand_digit(significand, significand_digits, current);
+                ++fraction_digits;
                 goto scan_number_decimal2;
             }
 
@@ -8251,6 +8539,7 @@ scan_number_exponent:
             case '-':
             {
                 add(current);
+                exponent_negative = current == '-';
                 goto scan_number_sign;
             }
 
@@ -8266,6 +8555,7 @@ scan_number_exponent:
             case '9':
             {
                 add(current);
+                add_exponent_digit(exponent, current);
                 goto scan_number_any2;
             }
 
@@ -8293,6 +8583,7 @@ scan_number_sign:
             case '9':
             {
                 add(current);
+                add_exponent_digit(exponent, current);
                 goto scan_number_any2;
             }
 
@@ -8319,6 +8610,7 @@ scan_number_any2:
             case '9':
             {
                 add(current);
+                add_exponent_digit(exponent, current);
                 goto scan_number_any2;
             }
 
@@ -8337,10 +8629,13 @@ scan_number_done:
         // try to parse integers first and fall back to floats
         if (number_type == token_type::value_unsigned)
         {
-            const auto x = std::strtoull(token_buffer.data(), &endptr, 10);
+            // up to 19 digits cannot overflow the collected significand
+            const auto x = significand_digits <= 19
+                           ? static_cast<unsigned long long>(significand)
+                           : std::strtoull(token_buffer.data(), &endptr, 10);
 
             // we checked the number format before
-            JSON_ASSERT(endptr == token_buffer.data() + token_buffer.size());
+            JSON_ASSERT(significand_digits <= 19 || endptr == token_buffer.data() + token_buffer.size());
 
             if (errno != ERANGE)
             {
@@ -8353,10 +8648,13 @@ scan_number_done:
         }
         else if (number_type == token_type::value_integer)
         {
-            const auto x = std::strtoll(token_buffer.data(), &endptr, 10);
+            // up to 18 digits are safely above -2^63
+            const auto x = significand_digits <= 18
+                           ? -static_cast<long long>(significand)
+                           : std::strtoll(token_buffer.data(), &endptr, 10);
 
             // we checked the number format before
-            JSON_ASSERT(endptr == token_buffer.data() + token_buffer.size());
+            JSON_ASSERT(significand_digits <= 18 || endptr == token_buffer.data() + token_buffer.size());
 
             if (errno != ERANGE)
             {
@@ -8370,6 +8668,13 @@ scan_number_done:
 
         // this code is reached if we parse a floating-point number or if an
         // integer conversion above failed
+        const long long decimal_exponent = (exponent_negative ? -exponent : exponent)
+                                           - static_cast<long long>(fraction_digits);
+        if (exact_float(value_float, significand, significand_digits, decimal_exponent, token_buffer[0] == '-'))
+        {
+            return token_type::value_float;
+        }
+
         strtof(value_float, token_buffer.data(), &endptr);
 
         // we checked the number format before
@@ -8407,18 +8712,75 @@ scan_number_done:
     void reset() noexcept
     {
         token_buffer.clear();
-        token_string.clear();
+        token_in_input = false;
         decimal_point_position = std::string::npos;
+        mark_token_start(is_contiguous_byte_input<InputAdapterType> {});
+    }
+
+    /*
+    The raw text of the last token is only needed for error messages. A
+    contiguous input still holds it, so the lexer just remembers where the
+    token began and rebuilds it in get_token_string(); other inputs are
+    consumed as they are read and keep a copy in token_string instead.
+    */
+
+    /// the token starts at current (or at the read position before any get())
+    void mark_token_start(std::true_type) noexcept
+    {
+        token_start = ia.data();
+        if (current != char_traits<char_type>::eof())
+        {
+            --token_start;
+        }
+    }
+
+    void mark_token_start(std::false_type) noexcept
+    {
+        token_string.clear();
+        if (current != char_traits<char_type>::eof())
+        {
+            token_string.push_back(char_traits<char_type>::to_char_type(current));
+        }
+    }
+
+    void record_token_char(std::true_type) noexcept {}
+
+    void record_token_char(std::false_type)
+    {
         token_string.push_back(char_traits<char_type>::to_char_type(current));
     }
 
+    void unrecord_token_char(std::true_type) noexcept {}
+
+    void unrecord_token_char(std::false_type)
+    {
+        JSON_ASSERT(!token_string.empty());
+        token_string.pop_back();
+    }
+
+    /// the characters read since the token started, without an ungot one
+    std::pair<const char_type*, const char_type*> token_range(std::true_type) const noexcept
+    {
+        const char_type* last = ia.data();
+        if (next_unget && current != char_traits<char_type>::eof())
+        {
+            --last;
+        }
+        return {token_start, last};
+    }
+
+    std::pair<const char_type*, const char_type*> token_range(std::false_type) const noexcept
+    {
+        return {token_string.data(), token_string.data() + token_string.size()};
+    }
+
     /*
     @brief get next character from the input
 
     This function provides the interface to the used input adapter. It does
     not throw in case the input reached EOF, but returns a
-    `char_traits<char>::eof()` in that case.  Stores the scanned characters
-    for use in error messages.
+    `char_traits<char>::eof()` in that case.  Records the scanned characters
+    for use in error messages (see mark_token_start).
 
     @return character read from the input
     */
@@ -8439,7 +8801,7 @@ scan_number_done:
 
         if (JSON_HEDLEY_LIKELY(current != char_traits<char_type>::eof()))
         {
-            token_string.push_back(char_traits<char_type>::to_char_type(current));
+            record_token_char(is_contiguous_byte_input<InputAdapterType> {});
         }
 
         if (current == '\n')
@@ -8456,7 +8818,7 @@ scan_number_done:
 
     We implement unget by setting variable next_unget to true. The input is not
     changed - we just simulate ungetting by modifying chars_read_total,
-    chars_read_current_line, and token_string. The next call to get() will
+    chars_read_current_line, and the recorded token. The next call to get() will
     behave as if the unget character is read again.
     */
     void unget()
@@ -8480,15 +8842,17 @@ scan_number_done:
 
         if (JSON_HEDLEY_LIKELY(current != char_traits<char_type>::eof()))
         {
-            JSON_ASSERT(!token_string.empty());
-            token_string.pop_back();
+            unrecord_token_char(is_contiguous_byte_input<InputAdapterType> {});
         }
     }
 
-    /// add a character to token_buffer
+    /// add a character to token_buffer (unless the string is still in the input)
     void add(char_int_type c)
     {
-        token_buffer.push_back(static_cast<typename string_t::value_type>(c));
+        if (!token_in_input)
+        {
+            token_buffer.push_back(static_cast<typename string_t::value_type>(c));
+        }
     }
 
   public:
@@ -8517,6 +8881,8 @@ scan_number_done:
     /// return current string value (implicitly resets the token; useful only once)
     string_t& get_string()
     {
+        materialize_string();
+
         // translate decimal points from locale back to '.' (#4084)
         if (decimal_point_char != '.' && decimal_point_position != std::string::npos)
         {
@@ -8525,6 +8891,19 @@ scan_number_done:
         return token_buffer;
     }
 
+    /// whether the last string is still only in the input (contiguous input, no escapes)
+    bool has_string_view() const noexcept
+    {
+        return token_in_input;
+    }
+
+    /// the last string as it stands in the input; only valid if has_string_view()
+    std::pair<const char*, std::size_t> get_string_view() const noexcept
+    {
+        JSON_ASSERT(token_in_input);
+        return string_in_input(is_contiguous_byte_input<InputAdapterType> {});
+    }
+
     /////////////////////
     // diagnostics
     /////////////////////
@@ -8540,10 +8919,13 @@ scan_number_done:
     /// 255 may legitimately occur.  May contain NUL, which should be escaped.
     std::string get_token_string() const
     {
+        const auto token = token_range(is_contiguous_byte_input<InputAdapterType> {});
+
         // escape control characters
         std::string result;
-        for (const auto c : token_string)
+        for (const char_type* it = token.first; it != token.second; ++it)
         {
+            const auto c = *it;
             if (static_cast<unsigned char>(c) <= '\x1F')
             {
                 // escape control characters
@@ -8703,12 +9085,18 @@ scan_number_done:
     /// the start position of the current token
     position_t position {};
 
-    /// raw input token string (for error messages)
+    /// raw input token string (for error messages; non-contiguous input)
     std::vector<char_type> token_string {};
 
+    /// where the last token began (for error messages; contiguous input)
+    const char_type* token_start = nullptr;
+
     /// buffer for variable-length tokens (numbers, strings)
     string_t token_buffer {};
 
+    /// whether the string being read is left in the input instead of token_buffer
+    bool token_in_input = false;
+
     /// a description of occurred lexer errors
     const char* error_message = "";
 
@@ -8938,6 +9326,13 @@ class json_sax_dom_parser
         return true;
     }
 
+    /// a string without escapes, built straight from the input
+    bool string_view(const char* s, std::size_t n)
+    {
+        handle_value(string_t(s, n));
+        return true;
+    }
+
     bool binary(binary_t& val)
     {
         handle_value(std::move(val));
@@ -8977,6 +9372,16 @@ class json_sax_dom_parser
         return true;
     }
 
+    /// a key without escapes, built straight from the input
+    bool key_view(const char* s, std::size_t n)
+    {
+        JSON_ASSERT(!ref_stack.empty());
+        JSON_ASSERT(ref_stack.back()->is_object());
+
+        object_element = &(ref_stack.back()->m_data.m_value.object->operator[](typename BasicJsonType::object_t::key_type(s, n)));
+        return true;
+    }
+
     bool end_object()
     {
         JSON_ASSERT(!ref_stack.empty());
@@ -9169,8 +9574,8 @@ class json_sax_dom_parser
 
     /// the parsed JSON value
     BasicJsonType& root;
-    /// stack to model hierarchy of values
-    std::vector<BasicJsonType*> ref_stack {};
+    /// stack to model hierarchy of values (from the value's allocator, like the value)
+    std::vector<BasicJsonType*, typename std::allocator_traits<typename BasicJsonType::allocator_type>::template rebind_alloc<BasicJsonType*>> ref_stack {};
     /// helper to hold the reference for the next object element
     BasicJsonType* object_element = nullptr;
     /// whether a syntax error occurred
@@ -9762,6 +10167,15 @@ template<typename T, typename String>
 using key_function_t =
     decltype(std::declval<T&>().key(std::declval<String&>()));
 
+// optional: strings that can be read straight from a contiguous input
+template<typename T>
+using key_view_function_t =
+    decltype(std::declval<T&>().key_view(std::declval<const char*>(), std::declval<std::size_t>()));
+
+template<typename T>
+using string_view_function_t =
+    decltype(std::declval<T&>().string_view(std::declval<const char*>(), std::declval<std::size_t>()));
+
 template<typename T>
 using end_object_function_t = decltype(std::declval<T&>().end_object());
 
@@ -13115,8 +13529,8 @@ class parser
     bool sax_parse_internal(SAX* sax)
     {
         // stack to remember the hierarchy of structured values we are parsing
-        // true = array; false = object
-        std::vector<bool> states;
+        // true = array; false = object (taken from the value's allocator)
+        std::vector<bool, typename std::allocator_traits<typename BasicJsonType::allocator_type>::template rebind_alloc<bool>> states;
         // value to avoid a goto (see comment where set to true)
         bool skip_to_state_evaluation = false;
 
@@ -13151,7 +13565,7 @@ class parser
                                                     m_lexer.get_token_string(),
                                                     parse_error::create(101, m_lexer.get_position(), exception_message(token_type::value_string, "object key"), nullptr));
                         }
-                        if (JSON_HEDLEY_UNLIKELY(!sax->key(m_lexer.get_string())))
+                        if (JSON_HEDLEY_UNLIKELY(!sax_key(sax, is_detected_exact<bool, key_view_function_t, SAX> {})))
                         {
                             return false;
                         }
@@ -13253,7 +13667,7 @@ class parser
 
                     case token_type::value_string:
                     {
-                        if (JSON_HEDLEY_UNLIKELY(!sax->string(m_lexer.get_string())))
+                        if (JSON_HEDLEY_UNLIKELY(!sax_string(sax, is_detected_exact<bool, string_view_function_t, SAX> {})))
                         {
                             return false;
                         }
@@ -13374,7 +13788,7 @@ class parser
                                                 parse_error::create(101, m_lexer.get_position(), exception_message(token_type::value_string, "object key"), nullptr));
                     }
 
-                    if (JSON_HEDLEY_UNLIKELY(!sax->key(m_lexer.get_string())))
+                    if (JSON_HEDLEY_UNLIKELY(!sax_key(sax, is_detected_exact<bool, key_view_function_t, SAX> {})))
                     {
                         return false;
                     }
@@ -13423,6 +13837,46 @@ class parser
         return last_token = m_lexer.scan();
     }
 
+    /*
+    A handler with key_view/string_view members gets strings without escapes
+    as a pointer into a contiguous input instead of a copy in the lexer's
+    buffer; the pointer is valid as long as the input is.
+    */
+
+    template<typename SAX>
+    bool sax_key(SAX* sax, std::true_type)
+    {
+        if (m_lexer.has_string_view())
+        {
+            const auto view = m_lexer.get_string_view();
+            return sax->key_view(view.first, view.second);
+        }
+        return sax->key(m_lexer.get_string());
+    }
+
+    template<typename SAX>
+    bool sax_key(SAX* sax, std::false_type)
+    {
+        return sax->key(m_lexer.get_string());
+    }
+
+    template<typename SAX>
+    bool sax_string(SAX* sax, std::true_type)
+    {
+        if (m_lexer.has_string_view())
+        {
+            const auto view = m_lexer.get_string_view();
+            return sax->string_view(view.first, view.second);
+        }
+        return sax->string(m_lexer.get_string());
+    }
+
+    template<typename SAX>
+    bool sax_string(SAX* sax, std::false_type)
+    {
+        return sax->string(m_lexer.get_string());
+    }
+
     std::string exception_message(const token_type expected, const std::string& context)
     {
         std::string error_msg = "syntax error ";
@@ -17715,6 +18169,7 @@ NLOHMANN_JSON_NAMESPACE_END
 #include <cstddef> // size_t, ptrdiff_t
 #include <cstdint> // uint8_t
 #include <cstdio> // snprintf
+#include <cstring> // memcpy
 #include <limits> // numeric_limits
 #include <string> // string, char_traits
 #include <iomanip> // setfill, setw
@@ -18772,6 +19227,94 @@ inline char* format_buffer(char* buf, int len, int decimal_exponent,
     return append_exponent(buf, n - 1);
 }
 
+/*!
+@brief writes a positive double that is a short decimal, such as 0.25, 1.5 or
+       1234.5, without running Grisu2
+
+Such a value is m / 10^k for an integer m and a small k. Because m and 10^k
+are exact doubles, the division is correctly rounded; if it gives back
+@a value, the decimal m * 10^-k round-trips. With at most 15 significant
+digits that decimal is the only one of its length that does, so the smallest
+such k gives exactly the digits Grisu2 would produce. The output has the same
+layout as format_buffer(). Returns nullptr (and writes nothing) for any other
+value, including those format_buffer() would write with an exponent.
+*/
+inline char* format_short_decimal(char* buf, double value)
+{
+#ifdef JSON_EXACT_DOUBLE_ARITHMETIC
+    static constexpr std::array<double, 8> powers_of_ten = {{1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7}};
+    static constexpr std::array<std::uint64_t, 8> integer_powers_of_ten = {{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000}};
+    constexpr double max_significand = 1e15; // 15 digits at most
+
+    if (!(value >= 1e-4 && value < 1e15))
+    {
+        return nullptr;
+    }
+
+    for (std::size_t k = 0; k < powers_of_ten.size(); ++k)
+    {
+        const double scaled = value * powers_of_ten[k];
+        if (scaled >= max_significand)
+        {
+            return nullptr;
+        }
+
+        const auto m = static_cast<std::uint64_t>(scaled + 0.5);
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+#endif
+        if (static_cast<double>(m) / powers_of_ten[k] != value)
+        {
+            continue;
+        }
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+        // integer digits, '.', and k fraction digits (or "0"), from the back
+        std::array<char, 32> digits{};
+        char* const digits_end = digits.data() + digits.size();
+        char* p = digits_end;
+
+        auto fraction = m % integer_powers_of_ten[k];
+        if (k == 0)
+        {
+            *--p = '0';
+        }
+        for (std::size_t i = 0; i < k; ++i)
+        {
+            *--p = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        *--p = '.';
+
+        auto integer = m / integer_powers_of_ten[k];
+        do
+        {
+            *--p = static_cast<char>('0' + integer % 10);
+            integer /= 10;
+        }
+        while (integer != 0);
+
+        const auto length = static_cast<std::size_t>(digits_end - p);
+        std::memcpy(buf, p, length);
+        return buf + length;
+    }
+#else
+    static_cast<void>(buf);
+    static_cast<void>(value);
+#endif
+    return nullptr;
+}
+
+/// other floating-point types always go through Grisu2
+template<typename FloatType>
+inline char* format_short_decimal(char* /*buf*/, FloatType /*value*/)
+{
+    return nullptr;
+}
+
 }  // namespace dtoa_impl
 
 /*!
@@ -18817,6 +19360,12 @@ char* to_chars(char* first, const char* last, FloatType value)
 
     JSON_ASSERT(last - first >= std::numeric_limits<FloatType>::max_digits10);
 
+    // short decimals are common and need no Grisu2
+    if (char* short_end = dtoa_impl::format_short_decimal(first, value))
+    {
+        return short_end;
+    }
+
     // Compute v = buffer * 10^decimal_exponent.
     // The decimal digits are stored in the buffer, which needs to be interpreted
     // as an unsigned decimal integer.
@@ -19226,6 +19775,35 @@ class serializer
 
         for (std::size_t i = 0; i < s.size(); ++i)
         {
+            // between code points, copy the run of characters that need
+            // neither escaping nor UTF-8 decoding in one go
+            if (state == UTF8_ACCEPT)
+            {
+                const std::size_t run = plain_ascii_run(s.data() + i, s.size() - i, ensure_ascii);
+                if (run != 0)
+                {
+                    if (string_buffer.size() - bytes >= run + 13)
+                    {
+                        std::memcpy(string_buffer.data() + bytes, s.data() + i, run);
+                        bytes += run;
+                    }
+                    else
+                    {
+                        o->write_characters(string_buffer.data(), bytes);
+                        o->write_characters(s.data() + i, run);
+                        bytes = 0;
+                    }
+                    bytes_after_last_accept = bytes;
+                    undumped_chars = 0;
+
+                    i += run;
+                    if (i == s.size())
+                    {
+                        break;
+                    }
+                }
+            }
+
             const auto byte = static_cast<std::uint8_t>(s[i]);
 
             switch (decode(state, codepoint, byte))
@@ -19461,40 +20039,6 @@ class serializer
     }
 
   private:
-    /*!
-    @brief count digits
-
-    Count the number of decimal (base 10) digits for an input unsigned integer.
-
-    @param[in] x  unsigned integer number to count its digits
-    @return    number of decimal digits
-    */
-    unsigned int count_digits(number_unsigned_t x) noexcept
-    {
-        unsigned int n_digits = 1;
-        for (;;)
-        {
-            if (x < 10)
-            {
-                return n_digits;
-            }
-            if (x < 100)
-            {
-                return n_digits + 1;
-            }
-            if (x < 1000)
-            {
-                return n_digits + 2;
-            }
-            if (x < 10000)
-            {
-                return n_digits + 3;
-            }
-            x = x / 10000u;
-            n_digits += 4;
-        }
-    }
-
     /*!
      * @brief convert a byte to a uppercase hex representation
      * @param[in] byte byte to represent
@@ -19562,33 +20106,15 @@ class serializer
             return;
         }
 
-        // use a pointer to fill the buffer
-        auto buffer_ptr = number_buffer.begin(); // NOLINT(llvm-qualified-auto,readability-qualified-auto,cppcoreguidelines-pro-type-vararg,hicpp-vararg)
-
-        number_unsigned_t abs_value;
+        const bool negative = is_negative_number(x);
+        number_unsigned_t abs_value = negative
+                                      ? remove_sign(static_cast<number_integer_t>(x))
+                                      : static_cast<number_unsigned_t>(x);
 
-        unsigned int n_chars{};
-
-        if (is_negative_number(x))
-        {
-            *buffer_ptr = '-';
-            abs_value = remove_sign(static_cast<number_integer_t>(x));
-
-            // account one more byte for the minus sign
-            n_chars = 1 + count_digits(abs_value);
-        }
-        else
-        {
-            abs_value = static_cast<number_unsigned_t>(x);
-            n_chars = count_digits(abs_value);
-        }
-
-        // spare 1 byte for '\0'
-        JSON_ASSERT(n_chars < number_buffer.size() - 1);
-
-        // jump to the end to generate the string from backward,
-        // so we later avoid reversing the result
-        buffer_ptr += static_cast<typename decltype(number_buffer)::difference_type>(n_chars);
+        // generate the string backward from the end of the buffer, so the
+        // digits need neither counting up front nor reversing
+        auto* const buffer_end = number_buffer.data() + number_buffer.size();
+        auto* buffer_ptr = buffer_end;
 
         // Fast int2ascii implementation inspired by "Fastware" talk by Andrei Alexandrescu
         // See: https://www.youtube.com/watch?v=o4-CwDo2zpg
@@ -19611,7 +20137,12 @@ class serializer
             *(--buffer_ptr) = static_cast<char>('0' + abs_value);
         }
 
-        o->write_characters(number_buffer.data(), n_chars);
+        if (negative)
+        {
+            *(--buffer_ptr) = '-';
+        }
+
+        o->write_characters(buffer_ptr, static_cast<std::size_t>(buffer_end - buffer_ptr));
     }
 
     /*!
@@ -20688,8 +21219,9 @@ class basic_json // NOLINT(cppcoreguidelines-special-member-functions,hicpp-spec
             }
             if (t == value_t::array || t == value_t::object)
             {
-                // flatten the current json_value to a heap-allocated stack
-                std::vector<basic_json> stack;
+                // flatten the current json_value to a stack allocated like
+                // the values themselves
+                std::vector<basic_json, AllocatorType<basic_json>> stack;
 
                 // move the top-level items to stack
                 if (t == value_t::array)
@@ -25529,6 +26061,8 @@ inline void swap(nlohmann::NLOHMANN_BASIC_JSON_TPL& j1, nlohmann::NLOHMANN_BASIC
 #undef JSON_NO_UNIQUE_ADDRESS
 #undef JSON_DISABLE_ENUM_SERIALIZATION
 #undef JSON_USE_GLOBAL_UDLS
+#undef JSON_USE_SSE2
+#undef JSON_EXACT_DOUBLE_ARITHMETIC
 
 #ifndef JSON_TEST_KEEP_MACROS
     #undef JSON_CATCH
@@ -4,153 +4,381 @@
 #include <windows.h>
 #include <gdiplus.h>
 #include <shellapi.h>
-#include <fstream>
-#include "json.hpp"
+#include <wtsapi32.h>
+#include "pet_fsm.hpp"
+#include "power_policy.hpp"
+#include "pet_world.hpp"
+#include "compositor.hpp"
+#include "display_geometry.hpp"
+#include "item_table.hpp"
+#include "arena.hpp"
+#include "alloc_guard.hpp"
+#include "gdi_handles.hpp"
+#include "save_file.hpp"
+#include "save_json.hpp"
+#include "save_schema.hpp"
+#include "mapped_file.hpp"
 #include <vector>
 #include <string>
 #include <ctime>
+#include <cstdio>
+#include <cstring>
 #include <map>
 
 using namespace Gdiplus;
-using json = nlohmann::json;
 
 #pragma comment(lib, "Gdiplus.lib")
 #pragma comment(lib, "shell32.lib")
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "gdi32.lib")
+#pragma comment(lib, "wtsapi32.lib")
 
 struct PokemonGIF {
-    std::wstring path;
-    Image* img;
+    const wchar_t* path; // in sessionStrings
+    std::vector<BitmapPtr> frames; // decoded once, premultiplied
     int frameCount;
-    int currentFrame;
     REAL width, height;
 };
 
-struct BulbasaurSet {
-    PokemonGIF idle;
-    PokemonGIF walkLeft, walkRight;
-    PokemonGIF sleepLeft, sleepRight;
-    PokemonGIF wakeLeft, wakeRight;
-    PokemonGIF tripLeft, tripRight;
-    PokemonGIF findItem;
-    PokemonGIF eat;
-    PokemonGIF* current = nullptr;
+// One species' animations indexed by PetAnim. Loaded once and shared by
+// every pet of that species; the pets themselves only keep a frame index.
+struct SpeciesSet {
+    PokemonGIF anims[ANIM_COUNT];
 };
 
-enum PetState {
-    STATE_IDLE,
-    STATE_WALK,
-    STATE_SLEEP,
-    STATE_WAKE,
-    STATE_TRIP,
-    STATE_FINDITEM,
-    STATE_EAT
+// assets\<species>\<species>-<suffix>.gif, in PetAnim order.
+const wchar_t* const animFiles[ANIM_COUNT] = {
+    L"idle",
+    L"walk-left", L"walk-right",
+    L"sleep-left", L"sleep-right",
+    L"wake-left", L"wake-right",
+    L"trip-left", L"trip-right",
+    L"finditem",
+    L"eat",
 };
 
 std::string selectedPokemon = "bulbasaur";
-BulbasaurSet bulbasaur;
 NOTIFYICONDATA nid{};
 ULONG_PTR gdiplusToken;
+HINSTANCE appInstance = NULL;
 
-POINT petPosition = {-1, -1};
-bool movingRight = true;
+POINT savedPosition = {-1, -1};
 bool exploreMode = false;
 
 int behaviorTimer = 0;
-DWORD lastInteraction = 0;
 DWORD sleepTimeout = 0.25 * 60 * 1000;
-int moveSpeed = 8;
+int moveSpeed = 8; // px per walk frame; the world walks at the same average speed
 int nudgeDistance = 50;
 UINT baseTimerSpeed = 16;
+UINT currentTickInterval = 0;
 
-DWORD lastAnimationTime = 0;
-UINT animIntervalIdle = 250;
-UINT animIntervalWalk = 150;
-UINT animIntervalSleep = 800;
-UINT animIntervalWake = 150;
-UINT animIntervalFindItem = 250; // faster find-item animation
-UINT animIntervalEat = 200;
+enum TimerId : UINT_PTR {
+    TIMER_TICK = 1,
+    TIMER_SLEEP = 2,
+    TIMER_SAVE = 3,
+    TIMER_HANDLE_REPORT = 4 // POKEBUDDY_HANDLE_TRACKING builds only
+};
 
-PetState currentState = STATE_IDLE;
-PetState previousState = STATE_IDLE;
+// Saving is kept out of the tick: a change arms a one-shot TIMER_SAVE and
+// the file is written once it fires, or on suspend and exit.
+UINT saveDelay = 5000;
+bool saveArmed = false;
+struct SaveSnapshot {
+    int x = 0, y = 0;
+    bool exploreMode = false;
+    unsigned bagRevision = 0;
+};
+SaveSnapshot lastSave;
+// The loaded save came from a newer build; it is kept as it is this session.
+bool saveReadOnly = false;
+// data.json checked out at load (or has been written since). When it did
+// not, the next save goes straight over it so it never displaces the backup.
+bool saveFileValid = false;
+
+constexpr UINT WM_APPBAR_NOTIFY = WM_APP + 2;
+
+PowerPolicy powerPolicy;
+HPOWERNOTIFY powerSourceNotify = NULL;
+HPOWERNOTIFY displayStateNotify = NULL;
+
+// Pets live in the world; the host window owns the one timer that ticks
+// them all. speciesSets and petWindows are index-aligned with
+// world.speciesInfo and the world's pet slots.
+PetWorld world;
+std::vector<SpeciesSet> speciesSets;
+Arena sessionStrings; // asset paths kept for the whole run
+std::vector<HWND> petWindows;
+HWND hwndHost = NULL;
+
+// What each pet last put on screen (index-aligned with the world), so a pet
+// whose frame and position didn't change costs nothing to render.
+struct DrawnPet {
+    Bitmap* frame = nullptr;
+    Bounds bounds;
+    bool shared = false;
+};
+std::vector<DrawnPet> drawnPets;
+
+// Scratch DC for per-pet windows and the cursor overlay: frames are drawn
+// here and handed to UpdateLayeredWindow. Grows to the largest frame seen
+// and is then reused, Graphics included.
+struct Canvas {
+    GdiBitmap bmp;
+    MemoryDC dc;
+    GraphicsPtr g;
+    int width = 0, height = 0;
+};
+Canvas canvas;
+
+// One layered window that pets close together on the taskbar strip are
+// composited into, instead of one UpdateLayeredWindow per pet.
+struct SharedSurface {
+    HWND hwnd = NULL;
+    Bounds bounds;
+    GdiBitmap bmp;
+    MemoryDC dc;
+    GraphicsPtr g;
+    bool visible = false;
+};
+SharedSurface surface;
+DisplayGeometry display;
+Bounds compositeRegion;
+CompositionPlanner planner;
+CompositionPlan plan;
+DirtyRegion surfaceDirty;
+std::vector<Bounds> petBounds;
 
 std::map<std::string, int> bag;
-std::string selectedItemForFeeding = "";
-Image* cursorImage = nullptr;
+unsigned bagRevision = 0; // bumped on every change to `bag`
+ItemTable items;
+int selectedItem = -1;      // item id held on the cursor, -1 for none
+
+enum MenuId : UINT {
+    MENU_EXPLORE = 1,
+    MENU_SUMMON = 2,
+    MENU_RETURN = 5,
+    MENU_EXPORT_SAVE = 6,
+    MENU_BAG_FIRST = 100
+};
+
+struct BagMenuEntry {
+    int item = 0; // id in `items`; its command id is MENU_BAG_FIRST + item
+    int count = 0;
+};
+
+// The right-click menu is built once and patched before it is shown; only
+// bag entries that appeared, vanished or changed count are touched.
+struct PetMenu {
+    HMENU menu = NULL;
+    HMENU bagMenu = NULL;
+    bool exploreShown = false;
+    unsigned bagRevision = 0;
+    std::vector<BagMenuEntry> entries; // bag submenu, same order as `bag`
+};
+PetMenu petMenu;
+ImagePtr cursorImage;
 
 HWND hwndCursorOverlay = NULL;
 bool cursorVisible = false;
 
-PokemonGIF loadGifSafe(std::wstring path) {
+PokemonGIF loadGifSafe(const wchar_t* path) {
     PokemonGIF pg{};
     pg.path = path;
-    pg.img = new Image(pg.path.c_str());
-    pg.frameCount = pg.img->GetFrameCount(&FrameDimensionTime);
-    pg.currentFrame = 0;
-    pg.width = pg.img->GetWidth();
-    pg.height = pg.img->GetHeight();
+    Image img(pg.path);
+    if (img.GetLastStatus() != Ok) return pg; // missing or broken file: no frames
+    pg.frameCount = img.GetFrameCount(&FrameDimensionTime);
+    pg.width = img.GetWidth();
+    pg.height = img.GetHeight();
+    for (int f = 0; f < pg.frameCount; ++f) {
+        img.SelectActiveFrame(&FrameDimensionTime, f);
+        BitmapPtr frame(new Bitmap((int)pg.width, (int)pg.height, PixelFormat32bppPARGB));
+        if (frame->GetLastStatus() != Ok) break;
+        Graphics g(frame.get());
+        g.Clear(Color(0, 0, 0, 0));
+        g.DrawImage(&img, 0.0f, 0.0f, pg.width, pg.height);
+        pg.frames.push_back(std::move(frame));
+    }
     return pg;
 }
 
-bool advanceFrame(PokemonGIF& pg) {
-    if (!pg.img) return false;
-    pg.currentFrame++;
-    if (pg.currentFrame >= pg.frameCount) {
-        pg.currentFrame = 0;
-        return true;
+// Returns the species' index, decoding its animations the first time only.
+uint16_t loadSpecies(const std::string& name) {
+    int known = world.findSpecies(name);
+    if (known >= 0) return (uint16_t)known;
+
+    SpeciesSet set;
+    SpeciesInfo info;
+    info.name = name;
+    for (int a = 0; a < ANIM_COUNT; ++a) {
+        PathBuilder path;
+        path << L"assets\\" << name << L"\\" << name << L"-" << animFiles[a] << L".gif";
+        set.anims[a] = loadGifSafe(path.keep(sessionStrings));
+        info.frameCount[a] = (uint16_t)set.anims[a].frameCount;
     }
-    pg.img->SelectActiveFrame(&FrameDimensionTime, pg.currentFrame);
-    return false;
-}
-
-void loadBulbasaur() {
-    std::wstring base = L"assets\\bulbasaur\\";
-    bulbasaur.idle       = loadGifSafe(base + L"bulbasaur-idle.gif");
-    bulbasaur.walkLeft   = loadGifSafe(base + L"bulbasaur-walk-left.gif");
-    bulbasaur.walkRight  = loadGifSafe(base + L"bulbasaur-walk-right.gif");
-    bulbasaur.sleepLeft  = loadGifSafe(base + L"bulbasaur-sleep-left.gif");
-    bulbasaur.sleepRight = loadGifSafe(base + L"bulbasaur-sleep-right.gif");
-    bulbasaur.wakeLeft   = loadGifSafe(base + L"bulbasaur-wake-left.gif");
-    bulbasaur.wakeRight  = loadGifSafe(base + L"bulbasaur-wake-right.gif");
-    bulbasaur.tripLeft   = loadGifSafe(base + L"bulbasaur-trip-left.gif");
-    bulbasaur.tripRight  = loadGifSafe(base + L"bulbasaur-trip-right.gif");
-    bulbasaur.findItem   = loadGifSafe(base + L"bulbasaur-finditem.gif");
-    bulbasaur.eat        = loadGifSafe(base + L"bulbasaur-eat.gif");
-    bulbasaur.current = &bulbasaur.idle;
+    info.width = (int)set.anims[ANIM_IDLE].width;
+    info.height = (int)set.anims[ANIM_IDLE].height;
+
+    speciesSets.push_back(std::move(set));
+    return world.addSpecies(std::move(info));
+}
+
+const wchar_t* const saveFile = L"data.json";
+const wchar_t* const saveBackupFile = L"data.json.bak"; // the save before the current one
+const wchar_t* const saveTempFile = L"data.json.tmp";
+const wchar_t* const readableSaveFile = L"data.readable.json";
+
+// data.json is written compact; --readable-save on the command line makes
+// it indented, and "Export Readable Save" writes an indented copy on demand.
+enum SaveFormat { SAVE_COMPACT, SAVE_READABLE };
+SaveFormat saveFormat = SAVE_COMPACT;
+
+// Saves serialize into one buffer that keeps its capacity between saves.
+std::string saveBuffer;
+nlohmann::detail::serializer<SaveJson> saveWriter(nlohmann::detail::output_adapter<char>(saveBuffer), ' ');
+
+// Writes `head` then `body` and flushes the file, so a rename afterwards
+// never exposes a partly written one.
+bool writeFileDurably(const wchar_t* path, const char* head, size_t headSize, const std::string& body) {
+    HANDLE file = CreateFile(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    DWORD written = 0, bodyWritten = 0;
+    bool ok = (headSize == 0 || (WriteFile(file, head, (DWORD)headSize, &written, NULL) && written == headSize)) &&
+        WriteFile(file, body.data(), (DWORD)body.size(), &bodyWritten, NULL) && bodyWritten == body.size();
+    ok = FlushFileBuffers(file) && ok;
+    CloseHandle(file);
+    return ok;
+}
+
+// Parses the save at `path` and brings it to the current schema; false if
+// it is missing, torn, not JSON or of an unusable version. Needs an open
+// SaveArenaScope.
+bool readSave(const wchar_t* path, SaveJson& j) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    return parseSave(file.data(), file.size(), j);
+}
+
+// Species names become asset paths, so only plain folder names are taken.
+bool isSpeciesName(const std::string& name) {
+    if (name.empty() || name.size() > 32) return false;
+    for (char c : name)
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_')) return false;
+    return true;
 }
 
 void loadData() {
-    std::ifstream f("data.json");
-    if (f) {
-        json j; f >> j;
-        if (j.contains("posX")) petPosition.x = j["posX"];
-        if (j.contains("posY")) petPosition.y = j["posY"];
-        if (j.contains("exploreMode")) exploreMode = j["exploreMode"];
-        if (j.contains("bag")) {
-            for (auto it = j["bag"].begin(); it != j["bag"].end(); ++it)
-                bag[it.key()] = it.value();
+    SaveArenaScope arenaScope;
+    SaveJson j;
+    saveFileValid = readSave(saveFile, j);
+    bool loaded = saveFileValid;
+    // A data.json.tmp that checks out is a save whose swap never finished,
+    // newer than data.json and the backup.
+    SaveJson pending;
+    if (readSave(saveTempFile, pending)) {
+        j = std::move(pending);
+        loaded = true;
+    }
+    if (loaded || readSave(saveBackupFile, j)) {
+        if (isNewerSave(j)) {
+            saveReadOnly = true;
+            OutputDebugStringA("PokeBuddy: data.json is from a newer version; not saving this session\n");
+        }
+        auto pet = j.find("pet");
+        if (pet != j.end() && pet->is_object()) {
+            auto species = pet->find("species");
+            if (species != pet->end() && species->is_string() && isSpeciesName(species->get<std::string>()))
+                selectedPokemon = species->get<std::string>();
+            auto x = pet->find("x"), y = pet->find("y");
+            if (x != pet->end() && x->is_number_integer()) savedPosition.x = x->get<int>();
+            if (y != pet->end() && y->is_number_integer()) savedPosition.y = y->get<int>();
+        }
+        auto explore = j.find("exploreMode");
+        if (explore != j.end() && explore->is_boolean()) exploreMode = explore->get<bool>();
+        auto saved = j.find("bag");
+        if (saved != j.end() && saved->is_object()) {
+            for (auto it = saved->begin(); it != saved->end(); ++it) {
+                if (!it.value().is_number_integer() || it.value().get<int>() <= 0) continue;
+                int item = items.internSaved(it.key());
+                if (item >= 0) bag[items.key(item)] = it.value().get<int>();
+            }
+            bagRevision++;
         }
     }
 }
 
-void saveData() {
-    json j;
-    j["pokemon"] = selectedPokemon;
-    j["posX"] = petPosition.x;
-    j["posY"] = petPosition.y;
+// Only the first pet is persisted; extra buddies last for the session.
+// Serializes the current state into saveBuffer.
+void serializeSave(SaveFormat format) {
+    SaveArenaScope arenaScope;
+    SaveJson j;
+    j["version"] = saveSchemaVersion;
+    j["pet"] = { { "species", world.speciesOf(0).name }, { "x", world.x[0] }, { "y", world.y[0] } };
     j["exploreMode"] = exploreMode;
-    j["bag"] = json::object();
+    j["bag"] = SaveJson::object();
     for (auto it = bag.begin(); it != bag.end(); ++it)
         j["bag"][it->first] = it->second;
-    std::ofstream f("data.json"); f << j.dump(4);
+
+    saveBuffer.clear();
+    bool pretty = format == SAVE_READABLE;
+    saveWriter.dump(j, pretty, false, pretty ? 4 : 0);
 }
 
-std::wstring humanizeItem(std::string key) {
-    std::wstring s(key.begin(), key.end());
-    for (auto& c : s) if (c == '-') c = ' ';
-    if (!s.empty()) s[0] = towupper(s[0]);
-    return s;
+void reportSaveError(const char* step, DWORD error) {
+    char message[96];
+    snprintf(message, sizeof(message), "PokeBuddy: save failed to %s (error %lu)\n", step, (unsigned long)error);
+    OutputDebugStringA(message);
+}
+
+void saveData() {
+    if (world.size() == 0 || saveReadOnly) return;
+    serializeSave(saveFormat);
+    char header[saveHeaderMax];
+    size_t headerSize = saveFrameHeader(saveBuffer.data(), saveBuffer.size(), header);
+    if (!writeFileDurably(saveTempFile, header, headerSize, saveBuffer)) {
+        reportSaveError("write data.json.tmp", GetLastError());
+        return;
+    }
+    // Swap the new save in and keep the old one as the backup. ReplaceFile
+    // needs an existing target, so the very first save is a plain move, as
+    // is one over a data.json that failed its check: rotating that into the
+    // backup would lose the last good save. Any other failure leaves the
+    // previous save, its backup or the finished .tmp for the loader and is
+    // retried with the next save.
+    if (!saveFileValid || !ReplaceFile(saveFile, saveTempFile, saveBackupFile, 0, NULL, NULL)) {
+        if (saveFileValid) {
+            DWORD error = GetLastError();
+            if (error != ERROR_FILE_NOT_FOUND) {
+                reportSaveError("replace data.json", error);
+                return;
+            }
+        }
+        if (!MoveFileEx(saveTempFile, saveFile, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            reportSaveError("create data.json", GetLastError());
+            return;
+        }
+        saveFileValid = true;
+    }
+
+    lastSave = { world.x[0], world.y[0], exploreMode, bagRevision };
+}
+
+// Plain indented JSON next to the save, for people rather than the loader.
+void exportReadableSave() {
+    if (world.size() == 0) return;
+    serializeSave(SAVE_READABLE);
+    writeFileDurably(readableSaveFile, nullptr, 0, saveBuffer);
+}
+
+bool saveNeeded() {
+    if (world.size() == 0) return false;
+    return lastSave.x != world.x[0] || lastSave.y != world.y[0] ||
+        lastSave.exploreMode != exploreMode || lastSave.bagRevision != bagRevision;
+}
+
+void scheduleSave() {
+    if (saveReadOnly || saveArmed || !saveNeeded()) return;
+    SetTimer(hwndHost, TIMER_SAVE, saveDelay, NULL);
+    saveArmed = true;
 }
 
 void CreateCursorOverlay(HINSTANCE hInst) {
@@ -170,6 +398,31 @@ void CreateCursorOverlay(HINSTANCE hInst) {
     ShowWindow(hwndCursorOverlay, SW_HIDE);
 }
 
+void releaseCanvas() {
+    canvas.g.reset();
+    canvas.dc.reset();
+    canvas.bmp.reset();
+    canvas.width = canvas.height = 0;
+}
+
+// Cleared and ready to draw at least width x height.
+Graphics& canvasFor(int width, int height) {
+    if (width > canvas.width || height > canvas.height) {
+        int w = (std::max)(width, canvas.width);
+        int h = (std::max)(height, canvas.height);
+        releaseCanvas();
+        ScreenDC screen;
+        canvas.dc.create();
+        canvas.bmp.reset(CreateCompatibleBitmap(screen.get(), w, h));
+        canvas.dc.select(canvas.bmp.get());
+        canvas.g.reset(new Graphics(canvas.dc.get()));
+        canvas.width = w;
+        canvas.height = h;
+    }
+    canvas.g->Clear(Color(0, 0, 0, 0));
+    return *canvas.g;
+}
+
 void renderCursorOverlay() {
     if (!cursorImage || !cursorVisible) return;
 
@@ -182,14 +435,8 @@ void renderCursorOverlay() {
     int offsetX = 16; // offset near cursor
     int offsetY = 16;
 
-    HDC screen = GetDC(NULL);
-    HDC mem = CreateCompatibleDC(screen);
-    HBITMAP bmp = CreateCompatibleBitmap(screen, width, height);
-    HGDIOBJ oldBmp = SelectObject(mem, bmp);
-
-    Graphics g(mem);
-    g.Clear(Color(0, 0, 0, 0));
-    g.DrawImage(cursorImage, (REAL)offsetX, (REAL)offsetY, (REAL)width, (REAL)height);
+    Graphics& g = canvasFor(width, height);
+    g.DrawImage(cursorImage.get(), (REAL)offsetX, (REAL)offsetY, (REAL)width, (REAL)height);
 
     BLENDFUNCTION blend{};
     blend.BlendOp = AC_SRC_OVER;
@@ -200,114 +447,268 @@ void renderCursorOverlay() {
     POINT ptSrc = { 0, 0 };
     POINT ptDest = { cursor.x, cursor.y };
 
-    UpdateLayeredWindow(hwndCursorOverlay, screen, &ptDest, &size, mem, &ptSrc, 0, &blend, ULW_ALPHA);
+    UpdateLayeredWindow(hwndCursorOverlay, NULL, &ptDest, &size, canvas.dc.get(), &ptSrc, 0, &blend, ULW_ALPHA);
     ShowWindow(hwndCursorOverlay, SW_SHOW);
+}
+
+// Re-arms the one-shot sleep deadline; the pet dozes off when TIMER_SLEEP
+// fires instead of comparing deadlines on every tick.
+void armSleepTimer() {
+    uint32_t delay;
+    if (world.nextSleepDelay(GetTickCount(), delay)) SetTimer(hwndHost, TIMER_SLEEP, delay, NULL);
+    else KillTimer(hwndHost, TIMER_SLEEP);
+}
+
+void noteInteraction(size_t pet) {
+    world.armSleep(pet, GetTickCount(), sleepTimeout);
+    armSleepTimer();
+}
+
+// Slows the shared timer down while every pet allows it (all asleep) or the
+// power policy asks for it, and stops it while suspended. An item held on
+// the cursor is moved and fed from the tick, so it keeps the base rate.
+// Only touches the timer when the period changes.
+void applyTickRate() {
+    UINT wanted = cursorVisible ? baseTimerSpeed : world.tickInterval(baseTimerSpeed);
+    UINT interval = powerPolicy.tickInterval(wanted);
+    if (interval == currentTickInterval) return;
+    currentTickInterval = interval;
+    if (interval == 0) KillTimer(hwndHost, TIMER_TICK);
+    else SetTimer(hwndHost, TIMER_TICK, interval, NULL);
+}
+
+Bounds toBounds(const RECT& r) {
+    return { (int)r.left, (int)r.top, (int)r.right, (int)r.bottom };
+}
+
+BOOL CALLBACK collectMonitor(HMONITOR monitor, HDC, LPRECT, LPARAM data) {
+    MONITORINFO mi{};
+    mi.cbSize = sizeof(mi);
+    if (GetMonitorInfo(monitor, &mi)) {
+        auto* layout = (std::vector<MonitorArea>*)data;
+        layout->push_back({ toBounds(mi.rcMonitor), toBounds(mi.rcWork), (mi.dwFlags & MONITORINFOF_PRIMARY) != 0 });
+    }
+    return TRUE;
+}
+
+// The only place monitors and the taskbar are queried; runs at startup and
+// on WM_DISPLAYCHANGE / work area changes, everything else reads the cache.
+void refreshDisplayGeometry() {
+    std::vector<MonitorArea> layout;
+    EnumDisplayMonitors(NULL, NULL, collectMonitor, (LPARAM)&layout);
+    RECT r{};
+    HWND taskbar = FindWindow(L"Shell_TrayWnd", NULL);
+    if (taskbar) GetWindowRect(taskbar, &r);
+    display.setLayout(std::move(layout), toBounds(r));
+
+    int tallest = 0;
+    for (const SpeciesInfo& info : world.speciesInfo) tallest = (std::max)(tallest, info.height);
+    // Pets standing on or just above the taskbar share one window.
+    compositeRegion = display.taskbarStrip(tallest);
+    world.fitToDisplay();
+}
+
+size_t petOf(HWND hwnd) {
+    return (size_t)GetWindowLongPtr(hwnd, GWLP_USERDATA);
+}
+
+size_t summonPet(uint16_t species, int x, int y) {
+    size_t pet = world.spawn(species, x, y);
+    const SpeciesInfo& info = world.speciesOf(pet);
+    HWND hwnd = CreateWindowEx(WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_TOOLWINDOW,
+        L"PetWindow", L"PokeBuddy", WS_POPUP, x, y, info.width, info.height,
+        NULL, NULL, appInstance, NULL);
+    SetWindowLongPtr(hwnd, GWLP_USERDATA, (LONG_PTR)pet);
+    petWindows.push_back(hwnd);
+    drawnPets.emplace_back();
+    ShowWindow(hwnd, SW_SHOW);
+    UpdateWindow(hwnd);
+    noteInteraction(pet);
+    return pet;
+}
 
-    SelectObject(mem, oldBmp);
-    DeleteObject(bmp);
-    DeleteDC(mem);
-    ReleaseDC(NULL, screen);
+// The world swap-removes, so the last pet's window moves into the freed slot.
+void dismissPet(size_t pet) {
+    DestroyWindow(petWindows[pet]);
+    world.despawn(pet);
+    petWindows[pet] = petWindows.back();
+    petWindows.pop_back();
+    if (drawnPets[pet].shared) surfaceDirty.add(drawnPets[pet].bounds);
+    drawnPets[pet] = drawnPets.back();
+    drawnPets.pop_back();
+    if (pet < petWindows.size()) SetWindowLongPtr(petWindows[pet], GWLP_USERDATA, (LONG_PTR)pet);
+    armSleepTimer();
+    applyTickRate();
 }
 
-void ShowRightClickMenu(HWND hwnd) {
-    HMENU hMenu = CreatePopupMenu();
-    HMENU hBagMenu = CreatePopupMenu();
+const wchar_t* exploreLabel() {
+    return exploreMode ? L"Disable Explore Mode" : L"Enable Explore Mode";
+}
 
-    AppendMenu(hMenu, MF_STRING, 1, exploreMode ? L"Disable Explore Mode" : L"Enable Explore Mode");
-    AppendMenu(hMenu, MF_POPUP, (UINT_PTR)hBagMenu, L"Bag");
+TextBuilder<128> bagLabel(const BagMenuEntry& e) {
+    TextBuilder<128> label;
+    label << items.displayName(e.item) << L" x " << e.count;
+    return label;
+}
 
-    int id = 100;
-    for (auto it = bag.begin(); it != bag.end(); ++it) {
-        std::wstring label = humanizeItem(it->first) + L" x " + std::to_wstring(it->second);
-        AppendMenu(hBagMenu, MF_STRING, id++, label.c_str());
+void buildPetMenu() {
+    petMenu.menu = CreatePopupMenu();
+    petMenu.bagMenu = CreatePopupMenu();
+    petMenu.exploreShown = exploreMode;
+    petMenu.bagRevision = bagRevision - 1; // fill the bag on the first sync
+
+    AppendMenu(petMenu.menu, MF_STRING, MENU_EXPLORE, exploreLabel());
+    AppendMenu(petMenu.menu, MF_STRING, MENU_SUMMON, L"Summon Another Buddy");
+    AppendMenu(petMenu.menu, MF_POPUP, (UINT_PTR)petMenu.bagMenu, L"Bag");
+    AppendMenu(petMenu.menu, MF_STRING, MENU_EXPORT_SAVE, L"Export Readable Save");
+    AppendMenu(petMenu.menu, MF_SEPARATOR, 0, NULL);
+    AppendMenu(petMenu.menu, MF_STRING, MENU_RETURN, L"Return to Pokeball");
+}
+
+// Brings the cached menu up to date. The bag and the submenu are both
+// sorted by item, so one merge pass finds what to insert, delete or relabel.
+void syncPetMenu() {
+    if (!petMenu.menu) buildPetMenu();
+    if (petMenu.exploreShown != exploreMode) {
+        ModifyMenu(petMenu.menu, MENU_EXPLORE, MF_BYCOMMAND | MF_STRING, MENU_EXPLORE, exploreLabel());
+        petMenu.exploreShown = exploreMode;
     }
+    if (petMenu.bagRevision == bagRevision) return;
+    petMenu.bagRevision = bagRevision;
+
+    std::vector<BagMenuEntry>& entries = petMenu.entries;
+    size_t pos = 0;
+    auto it = bag.begin();
+    while (it != bag.end() || pos < entries.size()) {
+        int order = it == bag.end() ? -1
+            : pos == entries.size() ? 1
+            : items.key(entries[pos].item).compare(it->first);
+        if (order < 0) {
+            DeleteMenu(petMenu.bagMenu, (UINT)pos, MF_BYPOSITION);
+            entries.erase(entries.begin() + pos);
+            continue;
+        }
+        if (order > 0) {
+            BagMenuEntry e{ items.intern(it->first), it->second };
+            InsertMenu(petMenu.bagMenu, (UINT)pos, MF_BYPOSITION | MF_STRING, MENU_BAG_FIRST + e.item, bagLabel(e).c_str());
+            entries.insert(entries.begin() + pos, std::move(e));
+        } else if (entries[pos].count != it->second) {
+            BagMenuEntry& e = entries[pos];
+            e.count = it->second;
+            UINT id = MENU_BAG_FIRST + e.item;
+            ModifyMenu(petMenu.bagMenu, id, MF_BYCOMMAND | MF_STRING, id, bagLabel(e).c_str());
+        }
+        ++pos;
+        ++it;
+    }
+}
 
-    AppendMenu(hMenu, MF_SEPARATOR, 0, NULL);
-    AppendMenu(hMenu, MF_STRING, 5, L"Return to Pokeball");
+void ShowRightClickMenu(HWND hwnd, size_t pet) {
+    syncPetMenu();
 
     POINT cursor;
     GetCursorPos(&cursor);
     SetForegroundWindow(hwnd);
-    int cmd = TrackPopupMenu(hMenu, TPM_RETURNCMD | TPM_TOPALIGN | TPM_LEFTALIGN,
+    UINT cmd = (UINT)TrackPopupMenu(petMenu.menu, TPM_RETURNCMD | TPM_TOPALIGN | TPM_LEFTALIGN,
         cursor.x, cursor.y, 0, hwnd, NULL);
+    if (cmd == 0) return; // dismissed
 
-    if (cmd == 1) exploreMode = !exploreMode;
-    else if (cmd >= 100) {
-        int idx = cmd - 100;
-        int i = 0;
-        for (auto it = bag.begin(); it != bag.end(); ++it, ++i) {
-            if (i == idx) {
-                if (it->second > 0) {
-                    selectedItemForFeeding = it->first;
-                    std::wstring berryPath = L"assets\\berries\\" + std::wstring(it->first.begin(), it->first.end()) + L".png";
-                    if (cursorImage) delete cursorImage;
-                    cursorImage = Image::FromFile(berryPath.c_str());
-                    cursorVisible = true;
-                }
-                break;
-            }
+    if (cmd == MENU_EXPLORE) {
+        exploreMode = !exploreMode;
+        saveData();
+    } else if (cmd == MENU_SUMMON) {
+        const SpeciesInfo& info = world.speciesOf(pet);
+        summonPet(world.species[pet], world.x[pet] - info.width, world.y[pet]);
+        applyTickRate();
+    } else if (cmd == MENU_EXPORT_SAVE) {
+        exportReadableSave();
+    } else if (cmd == MENU_RETURN) {
+        if (world.size() > 1) dismissPet(pet);
+        else PostQuitMessage(0);
+        saveData();
+    } else if (cmd >= MENU_BAG_FIRST && (int)(cmd - MENU_BAG_FIRST) < items.size()) {
+        int item = (int)(cmd - MENU_BAG_FIRST);
+        auto it = bag.find(items.key(item));
+        if (it != bag.end() && it->second > 0) {
+            selectedItem = item;
+            cursorImage = loadImage(items.iconPath(item));
+            cursorVisible = true;
+            applyTickRate();
         }
-    } else if (cmd == 5) PostQuitMessage(0);
-
-    DestroyMenu(hMenu);
-    saveData();
+    }
 }
 
-bool isCursorOverBulbasaur() {
-    POINT cursor; GetCursorPos(&cursor);
-    return cursor.x >= petPosition.x && cursor.x <= petPosition.x + (int)bulbasaur.current->width &&
-        cursor.y >= petPosition.y && cursor.y <= petPosition.y + (int)bulbasaur.current->height;
+void onPowerEvent(PowerSignal signal, bool active) {
+    if (!powerPolicy.apply({ signal, active })) return;
+    if (powerPolicy.mode() == POWER_SUSPENDED) saveData();
+    applyTickRate();
 }
 
-void handleFeeding() {
-    if (!selectedItemForFeeding.empty() && isCursorOverBulbasaur()) {
-        currentState = STATE_EAT;
-        bulbasaur.current = &bulbasaur.eat;
-        bulbasaur.current->currentFrame = 0;
-
-        bag[selectedItemForFeeding]--;
-        if (bag[selectedItemForFeeding] <= 0)
-            bag.erase(selectedItemForFeeding);
+// Power source and display state arrive as WM_POWERBROADCAST (both send
+// their current value right away), lock/unlock as WM_WTSSESSION_CHANGE and
+// fullscreen apps through the appbar callback.
+void registerPowerNotifications(HWND hwnd) {
+    powerSourceNotify = RegisterPowerSettingNotification(hwnd, &GUID_ACDC_POWER_SOURCE, DEVICE_NOTIFY_WINDOW_HANDLE);
+    displayStateNotify = RegisterPowerSettingNotification(hwnd, &GUID_CONSOLE_DISPLAY_STATE, DEVICE_NOTIFY_WINDOW_HANDLE);
+    WTSRegisterSessionNotification(hwnd, NOTIFY_FOR_THIS_SESSION);
+
+    APPBARDATA abd{};
+    abd.cbSize = sizeof(abd);
+    abd.hWnd = hwnd;
+    abd.uCallbackMessage = WM_APPBAR_NOTIFY;
+    SHAppBarMessage(ABM_NEW, &abd);
+}
 
-        std::wstring eatPath = L"assets\\berries\\" +
-            std::wstring(selectedItemForFeeding.begin(), selectedItemForFeeding.end()) +
-            L"-eat.gif";
+void unregisterPowerNotifications(HWND hwnd) {
+    APPBARDATA abd{};
+    abd.cbSize = sizeof(abd);
+    abd.hWnd = hwnd;
+    SHAppBarMessage(ABM_REMOVE, &abd);
 
-        if (cursorImage) delete cursorImage;
-        cursorImage = Image::FromFile(eatPath.c_str());
+    WTSUnRegisterSessionNotification(hwnd);
+    if (displayStateNotify) UnregisterPowerSettingNotification(displayStateNotify);
+    if (powerSourceNotify) UnregisterPowerSettingNotification(powerSourceNotify);
+}
 
-        selectedItemForFeeding.clear();
+void handleFeeding() {
+    if (selectedItem < 0) return;
+    POINT cursor; GetCursorPos(&cursor);
+    int pet = world.hitTest(cursor.x, cursor.y);
+    if (pet < 0 || !firePetEvent(world.machine[pet], EVENT_FEED)) return;
+
+    noteInteraction(pet);
+    const std::string& key = items.key(selectedItem);
+    if (--bag[key] <= 0)
+        bag.erase(key);
+    bagRevision++;
+
+    {
+        // Once per feeding, not per tick.
+        AllocGuardAllow eatAnimation;
+        cursorImage = loadImage(items.eatAnimPath(selectedItem));
     }
+
+    selectedItem = -1;
 }
 
-void trySpawnItem() {
+void trySpawnItem(size_t pet) {
     if (!exploreMode) return;
     int chance = rand() % 400;
-    if (chance < 2 && currentState != STATE_FINDITEM) {
-        std::vector<std::string> items = { "oran-berry", "sitrus-berry", "pecha-berry", "pokeball" };
-        std::string item = items[rand() % items.size()];
-        bag[item]++;
-        currentState = STATE_FINDITEM;
-        bulbasaur.current = &bulbasaur.findItem;
-        bulbasaur.current->currentFrame = 0;
+    if (chance < 2 && firePetEvent(world.machine[pet], EVENT_FOUND_ITEM)) {
+        AllocGuardAllow newBagEntry;
+        bag[items.key(rand() % foundItemCount)]++;
+        bagRevision++;
     }
 }
 
-void renderPokemon(HWND hwnd) {
-    PokemonGIF* pg = bulbasaur.current;
-    if (!pg || !pg->img) return;
-
-    HDC screen = GetDC(NULL);
-    HDC mem = CreateCompatibleDC(screen);
-    HBITMAP bmp = CreateCompatibleBitmap(screen, (int)pg->width, (int)pg->height);
-    HGDIOBJ oldBmp = SelectObject(mem, bmp);
+void renderPokemon(HWND hwnd, const PokemonGIF& pg, int frame, POINT pos) {
+    if (frame >= (int)pg.frames.size()) return;
 
-    Graphics g(mem);
-    g.Clear(Color(0, 0, 0, 0));
-    g.DrawImage(pg->img, 0.0f, 0.0f, pg->width, pg->height);
+    Graphics& g = canvasFor((int)pg.width, (int)pg.height);
+    g.DrawImage(pg.frames[frame].get(), 0.0f, 0.0f, pg.width, pg.height);
 
-    POINT ptDest = { petPosition.x, petPosition.y };
-    SIZE sizeWnd = { (LONG)pg->width, (LONG)pg->height };
+    POINT ptDest = pos;
+    SIZE sizeWnd = { (LONG)pg.width, (LONG)pg.height };
     POINT ptSrc = { 0,0 };
 
     BLENDFUNCTION blend{};
@@ -315,117 +716,306 @@ void renderPokemon(HWND hwnd) {
     blend.SourceConstantAlpha = 255;
     blend.AlphaFormat = AC_SRC_ALPHA;
 
-    UpdateLayeredWindow(hwnd, screen, &ptDest, &sizeWnd, mem, &ptSrc, 0, &blend, ULW_ALPHA);
+    UpdateLayeredWindow(hwnd, NULL, &ptDest, &sizeWnd, canvas.dc.get(), &ptSrc, 0, &blend, ULW_ALPHA);
+}
 
-    SelectObject(mem, oldBmp);
-    DeleteObject(bmp);
-    DeleteDC(mem);
-    ReleaseDC(NULL, screen);
+void releaseSurfaceBitmap() {
+    surface.g.reset();
+    surface.dc.reset();
+    surface.bmp.reset();
 }
 
-LRESULT CALLBACK PetProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+void resizeSurface(const Bounds& bounds) {
+    releaseSurfaceBitmap();
+    surface.bounds = bounds;
+
+    BITMAPINFO bmi{};
+    bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
+    bmi.bmiHeader.biWidth = bounds.width();
+    bmi.bmiHeader.biHeight = -bounds.height(); // top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = nullptr;
+    surface.dc.create();
+    surface.bmp.reset(CreateDIBSection(surface.dc.get(), &bmi, DIB_RGB_COLORS, &bits, NULL, 0));
+    surface.dc.select(surface.bmp.get());
+    surface.g.reset(new Graphics(surface.dc.get()));
+
+    surfaceDirty.clear();
+    surfaceDirty.add(bounds);
+}
+
+// Repaints only the dirty rects of the shared surface and hands the window
+// manager their union.
+void presentSurface() {
+    if (surfaceDirty.empty()) return;
+    const Bounds& sb = surface.bounds;
+
+    Graphics& g = *surface.g;
+    for (const Bounds& dirty : surfaceDirty) {
+        Bounds r = intersect(dirty, sb);
+        if (r.empty()) continue;
+        g.SetClip(Rect(r.left - sb.left, r.top - sb.top, r.width(), r.height()));
+        g.Clear(Color(0, 0, 0, 0));
+        for (size_t i = 0; i < world.size(); ++i) {
+            const DrawnPet& d = drawnPets[i];
+            if (d.shared && d.frame && intersects(d.bounds, r))
+                g.DrawImage(d.frame, d.bounds.left - sb.left, d.bounds.top - sb.top, d.bounds.width(), d.bounds.height());
+        }
+    }
+    g.ResetClip();
+
+    Bounds all = intersect(surfaceDirty.bounds(), sb);
+    RECT dirty = { all.left - sb.left, all.top - sb.top, all.right - sb.left, all.bottom - sb.top };
+    POINT ptDest = { sb.left, sb.top };
+    SIZE size = { sb.width(), sb.height() };
+    POINT ptSrc = { 0, 0 };
+
+    BLENDFUNCTION blend{};
+    blend.BlendOp = AC_SRC_OVER;
+    blend.SourceConstantAlpha = 255;
+    blend.AlphaFormat = AC_SRC_ALPHA;
+
+    UPDATELAYEREDWINDOWINFO info{};
+    info.cbSize = sizeof(info);
+    info.pptDst = &ptDest;
+    info.psize = &size;
+    info.hdcSrc = surface.dc.get();
+    info.pptSrc = &ptSrc;
+    info.pblend = &blend;
+    info.dwFlags = ULW_ALPHA;
+    info.prcDirty = &dirty;
+    UpdateLayeredWindowIndirect(surface.hwnd, &info);
+
+    if (!surface.visible) {
+        ShowWindow(surface.hwnd, SW_SHOWNOACTIVATE);
+        surface.visible = true;
+    }
+    SetWindowPos(surface.hwnd, HWND_TOPMOST, 0, 0, 0, 0,
+        SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE | SWP_NOOWNERZORDER);
+    surfaceDirty.clear();
+}
+
+// Pets in the shared plan mark the surface dirty; the rest update their own
+// window. Either way nothing is drawn for a pet whose frame and position
+// are unchanged since the last tick.
+void renderPets() {
+    size_t n = world.size();
+    petBounds.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const PokemonGIF& pg = speciesSets[world.species[i]].anims[currentAnim(world.machine[i])];
+        petBounds[i] = boundsAt(world.x[i], world.y[i], (int)pg.width, (int)pg.height);
+    }
+    if (planner.plan(petBounds.data(), n, compositeRegion, plan) && plan.shared)
+        resizeSurface(plan.surface);
+
+    for (size_t i = 0; i < n; ++i) {
+        const PokemonGIF& pg = speciesSets[world.species[i]].anims[currentAnim(world.machine[i])];
+        int f = world.frame[i];
+        Bitmap* frame = f < (int)pg.frames.size() ? pg.frames[f].get() : nullptr;
+        DrawnPet& d = drawnPets[i];
+        bool shared = plan.inShared[i] != 0;
+        bool changed = d.frame != frame || d.bounds != petBounds[i];
+
+        if (shared) {
+            if (!d.shared) ShowWindow(petWindows[i], SW_HIDE);
+            if (changed || !d.shared) {
+                if (d.shared) surfaceDirty.add(d.bounds);
+                surfaceDirty.add(petBounds[i]);
+            }
+        } else {
+            if (d.shared) {
+                surfaceDirty.add(d.bounds);
+                ShowWindow(petWindows[i], SW_SHOWNOACTIVATE);
+            }
+            if (changed || d.shared) {
+                // A pet that only walked keeps its window contents.
+                POINT pos = { world.x[i], world.y[i] };
+                if (d.frame != frame || d.shared || d.bounds.width() != petBounds[i].width() ||
+                    d.bounds.height() != petBounds[i].height())
+                    renderPokemon(petWindows[i], pg, f, pos);
+                SetWindowPos(petWindows[i], HWND_TOPMOST, pos.x, pos.y, 0, 0,
+                    SWP_NOSIZE | SWP_NOACTIVATE | SWP_NOOWNERZORDER);
+            }
+        }
+        d.frame = frame;
+        d.bounds = petBounds[i];
+        d.shared = shared;
+    }
+
+    if (plan.shared) presentSurface();
+    else if (surface.visible) {
+        ShowWindow(surface.hwnd, SW_HIDE);
+        surface.visible = false;
+        surfaceDirty.clear();
+    }
+}
+
+// Runs on every timer tick, so it must not allocate once the pets have
+// settled; POKEBUDDY_ALLOC_GUARD builds report any allocation by stage.
+void tickWorld() {
+    AllocGuardScope guard;
+    DWORD now = GetTickCount();
+    ALLOC_STAGE("trySpawnItem");
+    for (size_t i = 0; i < world.size(); ++i) trySpawnItem(i);
+    ALLOC_STAGE("handleFeeding");
+    handleFeeding();
+
+    ALLOC_STAGE("world.tick");
+    unsigned effects = world.tick(now);
+    if (effects & EFFECT_FEED_DONE) {
+        cursorImage.reset();
+        ShowWindow(hwndCursorOverlay, SW_HIDE);
+        cursorVisible = false;
+    }
+
+    ALLOC_STAGE("renderPets");
+    renderPets();
+    ALLOC_STAGE("renderCursorOverlay");
+    if (cursorVisible) renderCursorOverlay();
+    ALLOC_STAGE("scheduleSave");
+    scheduleSave();
+    ALLOC_STAGE("applyTickRate");
+    applyTickRate();
+}
+
+// Owns the shared timer, the tray icon and the power notifications; never shown.
+LRESULT CALLBACK HostProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_CREATE:
-        SetTimer(hwnd, 1, baseTimerSpeed, NULL);
         srand((unsigned)time(NULL));
-        lastInteraction = GetTickCount();
+        registerPowerNotifications(hwnd);
         return 0;
 
-    case WM_TIMER: {
-        DWORD now = GetTickCount();
-        trySpawnItem();
-        handleFeeding();
+    case WM_TIMER:
+        if (wParam == TIMER_HANDLE_REPORT) {
+            reportLiveHandles();
+        } else if (wParam == TIMER_SAVE) {
+            KillTimer(hwnd, TIMER_SAVE);
+            saveArmed = false;
+            saveData();
+        } else if (wParam == TIMER_SLEEP) {
+            KillTimer(hwnd, TIMER_SLEEP);
+            world.expireSleepDeadlines(GetTickCount(), sleepTimeout);
+            armSleepTimer();
+            applyTickRate();
+        } else {
+            tickWorld();
+        }
+        return 0;
 
-        switch (currentState) {
-        case STATE_IDLE:
-            if (bulbasaur.current != &bulbasaur.idle) {
-                bulbasaur.current = &bulbasaur.idle;
-                bulbasaur.current->currentFrame = 0;
-            }
-            if (now - lastAnimationTime >= animIntervalIdle) {
-                lastAnimationTime = now;
-                advanceFrame(*bulbasaur.current);
-            }
-            break;
+    case WM_POWERBROADCAST:
+        if (wParam == PBT_POWERSETTINGCHANGE) {
+            auto* setting = (POWERBROADCAST_SETTING*)lParam;
+            DWORD value = *(DWORD*)setting->Data;
+            if (IsEqualGUID(setting->PowerSetting, GUID_ACDC_POWER_SOURCE))
+                onPowerEvent(SIGNAL_ON_BATTERY, value != 0); // 0 = AC
+            else if (IsEqualGUID(setting->PowerSetting, GUID_CONSOLE_DISPLAY_STATE))
+                onPowerEvent(SIGNAL_DISPLAY_OFF, value == 0); // 1 = on, 2 = dimmed
+        }
+        return TRUE;
 
-        case STATE_WALK:
-            if (bulbasaur.current != (movingRight ? &bulbasaur.walkRight : &bulbasaur.walkLeft)) {
-                bulbasaur.current = movingRight ? &bulbasaur.walkRight : &bulbasaur.walkLeft;
-                bulbasaur.current->currentFrame = 0;
-            }
-            if (now - lastAnimationTime >= animIntervalWalk) {
-                lastAnimationTime = now;
-                advanceFrame(*bulbasaur.current);
-                petPosition.x += movingRight ? moveSpeed : -moveSpeed;
-            }
-            break;
+    case WM_WTSSESSION_CHANGE:
+        if (wParam == WTS_SESSION_LOCK) onPowerEvent(SIGNAL_SESSION_LOCKED, true);
+        else if (wParam == WTS_SESSION_UNLOCK) onPowerEvent(SIGNAL_SESSION_LOCKED, false);
+        return 0;
 
-        case STATE_FINDITEM:
-            if (now - lastAnimationTime >= animIntervalFindItem) {
-                lastAnimationTime = now;
-                bool done = advanceFrame(*bulbasaur.current);
-                if (done) currentState = STATE_IDLE;
-            }
-            break;
-
-        case STATE_EAT:
-            if (now - lastAnimationTime >= animIntervalEat) {
-                lastAnimationTime = now;
-                bool done = advanceFrame(*bulbasaur.current);
-                if (done) {
-                    currentState = STATE_IDLE;
-                    if (cursorImage) { delete cursorImage; cursorImage = nullptr; }
-                    ShowWindow(hwndCursorOverlay, SW_HIDE);
-                    cursorVisible = false;
-                }
-            }
-            break;
-        }
+    case WM_APPBAR_NOTIFY:
+        if (wParam == ABN_FULLSCREENAPP) onPowerEvent(SIGNAL_FULLSCREEN_APP, lParam != 0);
+        return 0;
 
-        renderPokemon(hwnd);
-        if (cursorVisible) renderCursorOverlay();
-        SetWindowPos(hwnd, HWND_TOPMOST, petPosition.x, petPosition.y, 0, 0,
-            SWP_NOSIZE | SWP_NOACTIVATE | SWP_NOOWNERZORDER);
-        saveData();
+    case WM_DISPLAYCHANGE:
+        refreshDisplayGeometry();
+        return 0;
+
+    case WM_SETTINGCHANGE:
+        if (wParam == SPI_SETWORKAREA) refreshDisplayGeometry();
         return 0;
+
+    case WM_DESTROY:
+        PostQuitMessage(0);
+        return 0;
+    }
+    return DefWindowProc(hwnd, msg, wParam, lParam);
+}
+
+void onPetClick(size_t pet) {
+    noteInteraction(pet);
+    PetMachine& m = world.machine[pet];
+    if (firePetEvent(m, EVENT_CLICK)) {
+        if (m.state == STATE_WALK) setFacing(m, rand() % 2);
+        applyTickRate();
     }
+}
 
+void onPetMenu(HWND hwnd, size_t pet) {
+    noteInteraction(pet);
+    ShowRightClickMenu(hwnd, pet);
+}
+
+LRESULT CALLBACK PetProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
     case WM_LBUTTONDOWN:
-        lastInteraction = GetTickCount();
-        if (currentState == STATE_IDLE) {
-            currentState = STATE_WALK;
-            movingRight = rand() % 2;
-        }
+        onPetClick(petOf(hwnd));
         break;
 
     case WM_RBUTTONDOWN:
-        ShowRightClickMenu(hwnd);
+        onPetMenu(hwnd, petOf(hwnd));
         return 0;
+    }
+    return DefWindowProc(hwnd, msg, wParam, lParam);
+}
 
-    case WM_DESTROY:
-        PostQuitMessage(0);
-        return 0;
+// The shared surface covers several pets; clicks go to whichever is under
+// the cursor (transparent pixels already fall through to the desktop).
+LRESULT CALLBACK SurfaceProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_LBUTTONDOWN:
+    case WM_RBUTTONDOWN: {
+        POINT cursor; GetCursorPos(&cursor);
+        int pet = world.hitTest(cursor.x, cursor.y);
+        if (pet < 0) break;
+        if (msg == WM_LBUTTONDOWN) onPetClick(pet);
+        else { onPetMenu(hwnd, pet); return 0; }
+        break;
+    }
     }
     return DefWindowProc(hwnd, msg, wParam, lParam);
 }
 
-int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int) {
+int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR cmdLine, int) {
     GdiplusStartupInput gsi;
     GdiplusStartup(&gdiplusToken, &gsi, NULL);
+#ifdef POKEBUDDY_ALLOC_GUARD
+    allocGuardReport = [](const char* message) { OutputDebugStringA(message); };
+#endif
+    appInstance = hInst;
+    if (cmdLine && strstr(cmdLine, "--readable-save")) saveFormat = SAVE_READABLE;
 
     loadData();
-    loadBulbasaur();
-
-    if (petPosition.x == -1 || petPosition.y == -1) {
-        RECT r;
-        HWND taskbar = FindWindow(L"Shell_TrayWnd", NULL);
-        GetWindowRect(taskbar, &r);
-        petPosition.x = r.right - (int)bulbasaur.current->width - 80;
-        int h = r.bottom - r.top;
-        petPosition.y = r.top + h - (int)bulbasaur.current->height + 2;
-        saveData();
+    uint16_t species = loadSpecies(selectedPokemon);
+    if (world.speciesInfo[species].width == 0 && selectedPokemon != "bulbasaur")
+        species = loadSpecies("bulbasaur"); // saved species has no assets here
+
+    world.display = &display;
+    world.walkSpeed = moveSpeed * 1000.0f / animIntervalWalk;
+    refreshDisplayGeometry();
+
+    if (savedPosition.x == -1 || savedPosition.y == -1) {
+        const SpeciesInfo& info = world.speciesInfo[species];
+        Bounds spot = display.restingSpot(info.width, info.height);
+        savedPosition.x = spot.left;
+        savedPosition.y = spot.top;
     }
 
+    WNDCLASS hostClass{};
+    hostClass.lpfnWndProc = HostProc;
+    hostClass.hInstance = hInst;
+    hostClass.lpszClassName = L"PokeBuddyHost";
+    RegisterClass(&hostClass);
+
     WNDCLASS wc{};
     wc.lpfnWndProc = PetProc;
     wc.hInstance = hInst;
@@ -433,18 +1023,31 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int) {
     wc.hCursor = LoadCursor(NULL, IDC_ARROW);
     RegisterClass(&wc);
 
-    HWND hwnd = CreateWindowEx(WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_TOOLWINDOW,
-        L"PetWindow", L"PokeBuddy", WS_POPUP, petPosition.x, petPosition.y,
-        (int)bulbasaur.current->width, (int)bulbasaur.current->height,
-        NULL, NULL, hInst, NULL);
+    WNDCLASS surfaceClass{};
+    surfaceClass.lpfnWndProc = SurfaceProc;
+    surfaceClass.hInstance = hInst;
+    surfaceClass.lpszClassName = L"PetSurface";
+    surfaceClass.hCursor = LoadCursor(NULL, IDC_ARROW);
+    RegisterClass(&surfaceClass);
+
+    hwndHost = CreateWindowEx(WS_EX_TOOLWINDOW, L"PokeBuddyHost", L"PokeBuddy", WS_POPUP,
+        0, 0, 0, 0, NULL, NULL, hInst, NULL);
+
+    surface.hwnd = CreateWindowEx(WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_TOOLWINDOW,
+        L"PetSurface", L"PokeBuddy", WS_POPUP, 0, 0, 1, 1, NULL, NULL, hInst, NULL);
 
     CreateCursorOverlay(hInst);
 
-    ShowWindow(hwnd, SW_SHOW);
-    UpdateWindow(hwnd);
+    summonPet(species, savedPosition.x, savedPosition.y);
+    world.fitToDisplay();
+    saveData();
+    applyTickRate();
+#ifdef POKEBUDDY_HANDLE_TRACKING
+    SetTimer(hwndHost, TIMER_HANDLE_REPORT, 60 * 1000, NULL);
+#endif
 
     nid.cbSize = sizeof(nid);
-    nid.hWnd = hwnd;
+    nid.hWnd = hwndHost;
     nid.uID = 1;
     nid.uFlags = NIF_MESSAGE | NIF_ICON | NIF_TIP;
     nid.uCallbackMessage = WM_APP + 1;
@@ -459,6 +1062,14 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR, int) {
         DispatchMessage(&msg);
     }
 
+    saveData();
+    unregisterPowerNotifications(hwndHost);
+    releaseSurfaceBitmap();
+    releaseCanvas();
+    cursorImage.reset();
+    speciesSets.clear();
+    reportLiveHandles(); // all zero unless something leaked
+    if (petMenu.menu) DestroyMenu(petMenu.menu);
     Shell_NotifyIcon(NIM_DELETE, &nid);
     GdiplusShutdown(gdiplusToken);
     return 0;
@@ -0,0 +1,78 @@
+#pragma once
+
+// Read-only view of a whole file through a file mapping, so the save can
+// be validated and parsed straight from the page cache instead of being
+// copied into a string (or pulled through an istream) first. The file is
+// opened without write sharing: nobody can truncate it under the view.
+// Setting up a mapping costs more than it saves on a small file, so files
+// below mapThreshold are read into a buffer instead (tests/bench_save_read).
+
+#include <windows.h>
+
+#include <cstddef>
+#include <vector>
+
+constexpr size_t mapThreshold = 64 * 1024;
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const wchar_t* path) { open(path); }
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False if the file is missing or cannot be read or mapped. An empty file
+    // opens fine with size() 0.
+    bool open(const wchar_t* path) {
+        close();
+        file = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || (unsigned long long)size.QuadPart > (size_t)-1) {
+            close();
+            return false;
+        }
+        length = (size_t)size.QuadPart;
+        if (length < mapThreshold) {
+            buffer.resize(length);
+            DWORD read = 0;
+            if (length && (!ReadFile(file, buffer.data(), (DWORD)length, &read, NULL) || read != length)) {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        view = nullptr;
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+        length = 0;
+        buffer.clear();
+    }
+
+    const char* data() const { return view ? (const char*)view : buffer.data(); }
+    size_t size() const { return length; }
+
+private:
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    void* view = nullptr;
+    std::vector<char> buffer; // the whole file when it is below mapThreshold
+    size_t length = 0;
+};
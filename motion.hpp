@@ -0,0 +1,37 @@
+#pragma once
+
+// Fixed-timestep clock for pet movement. Timer ticks arrive whenever the
+// OS gets round to them (16 ms, 50 ms, 800 ms while asleep); the clock
+// turns them into whole motion steps plus the fraction of a step left
+// over, which the world uses to interpolate what it shows.
+
+#include <cstdint>
+
+constexpr uint32_t motionStepMs = 10;
+// Longest gap simulated in one go; after a suspend pets don't teleport.
+constexpr uint32_t motionMaxCatchUpMs = 250;
+
+struct MotionClock {
+    uint32_t last = 0;
+    uint32_t carry = 0;
+    bool started = false;
+
+    // Whole steps to simulate for this tick.
+    unsigned advance(uint32_t now) {
+        if (!started) {
+            started = true;
+            last = now;
+            return 0;
+        }
+        uint32_t elapsed = now - last;
+        last = now;
+        if (elapsed > motionMaxCatchUpMs) elapsed = motionMaxCatchUpMs;
+        carry += elapsed;
+        unsigned steps = carry / motionStepMs;
+        carry %= motionStepMs;
+        return steps;
+    }
+
+    // How far the present time is past the last simulated step, 0..1.
+    float alpha() const { return (float)carry / motionStepMs; }
+};
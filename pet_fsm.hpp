@@ -0,0 +1,215 @@
+#pragma once
+
+// Pet behaviour as data: one row per state, one row per event transition,
+// and a small interpreter that runs them. Nothing in here touches Win32, so
+// the machine is checked at compile time and can be driven headless.
+
+#include <cstdint>
+
+enum PetState {
+    STATE_IDLE,
+    STATE_WALK,
+    STATE_SLEEP,
+    STATE_WAKE,
+    STATE_TRIP,
+    STATE_FINDITEM,
+    STATE_EAT,
+    STATE_COUNT
+};
+
+// Directional animations come in left/right pairs, left first.
+enum PetAnim {
+    ANIM_IDLE,
+    ANIM_WALK_LEFT, ANIM_WALK_RIGHT,
+    ANIM_SLEEP_LEFT, ANIM_SLEEP_RIGHT,
+    ANIM_WAKE_LEFT, ANIM_WAKE_RIGHT,
+    ANIM_TRIP_LEFT, ANIM_TRIP_RIGHT,
+    ANIM_FINDITEM,
+    ANIM_EAT,
+    ANIM_COUNT
+};
+
+enum PetEvent {
+    EVENT_CLICK,
+    EVENT_FOUND_ITEM,
+    EVENT_FEED,
+    EVENT_SLEEP_TIMEOUT, // the host's sleepTimeout deadline expired
+    EVENT_BUMP,          // walked into the edge of the screen
+    EVENT_COUNT
+};
+
+enum StateFlags : unsigned {
+    STATE_FLAG_DIRECTIONAL  = 1u << 0, // anim is the left variant, anim + 1 faces right
+    STATE_FLAG_MOVES        = 1u << 1, // walks at a steady speed in the facing direction
+    STATE_FLAG_ENDS_FEEDING = 1u << 2, // finishing the animation clears the cursor item
+    STATE_FLAG_LOW_RATE     = 1u << 3  // host may tick at the state's interval instead of its base rate
+};
+
+// What a tick asks the caller to do; the table decides, the caller applies.
+enum PetEffects : unsigned {
+    EFFECT_NONE      = 0,
+    EFFECT_FEED_DONE = 1u << 0,
+    EFFECT_ENTERED   = 1u << 1  // the tick ended in a different state
+};
+
+constexpr unsigned animIntervalIdle = 250;
+constexpr unsigned animIntervalWalk = 150;
+constexpr unsigned animIntervalSleep = 800;
+constexpr unsigned animIntervalWake = 150;
+constexpr unsigned animIntervalTrip = 150;
+constexpr unsigned animIntervalFindItem = 250; // faster find-item animation
+constexpr unsigned animIntervalEat = 200;
+
+// GetTickCount() only moves in ~16 ms steps, so a frame counts as due this
+// close to its interval. Without it a timer running at exactly the interval
+// would skip every other frame.
+constexpr unsigned tickSlack = 16;
+
+struct StateDef {
+    PetState state;
+    PetAnim anim;
+    unsigned interval;   // ms between frames
+    PetState onComplete; // entered when the animation wraps; itself to loop
+    unsigned flags;
+};
+
+struct Transition {
+    PetEvent event;
+    unsigned from;       // guard: bitmask of states that accept the event
+    PetState to;
+};
+
+constexpr unsigned stateBit(PetState s) { return 1u << s; }
+constexpr unsigned ANY_STATE = (1u << STATE_COUNT) - 1;
+
+constexpr StateDef stateTable[STATE_COUNT] = {
+    // state          animation        interval              on complete     flags
+    { STATE_IDLE,     ANIM_IDLE,       animIntervalIdle,     STATE_IDLE,     0 },
+    { STATE_WALK,     ANIM_WALK_LEFT,  animIntervalWalk,     STATE_WALK,     STATE_FLAG_DIRECTIONAL | STATE_FLAG_MOVES },
+    { STATE_SLEEP,    ANIM_SLEEP_LEFT, animIntervalSleep,    STATE_SLEEP,    STATE_FLAG_DIRECTIONAL | STATE_FLAG_LOW_RATE },
+    { STATE_WAKE,     ANIM_WAKE_LEFT,  animIntervalWake,     STATE_IDLE,     STATE_FLAG_DIRECTIONAL },
+    { STATE_TRIP,     ANIM_TRIP_LEFT,  animIntervalTrip,     STATE_IDLE,     STATE_FLAG_DIRECTIONAL },
+    { STATE_FINDITEM, ANIM_FINDITEM,   animIntervalFindItem, STATE_IDLE,     0 },
+    { STATE_EAT,      ANIM_EAT,        animIntervalEat,      STATE_IDLE,     STATE_FLAG_ENDS_FEEDING },
+};
+
+// First matching row wins.
+constexpr Transition transitionTable[] = {
+    // event               accepted in                                                                            goes to
+    { EVENT_CLICK,         stateBit(STATE_IDLE),                                                                  STATE_WALK },
+    { EVENT_CLICK,         stateBit(STATE_SLEEP),                                                                 STATE_WAKE },
+    // not while eating: leaving STATE_EAT early would skip EFFECT_FEED_DONE
+    { EVENT_FOUND_ITEM,    ANY_STATE & ~(stateBit(STATE_FINDITEM) | stateBit(STATE_SLEEP) | stateBit(STATE_EAT)), STATE_FINDITEM },
+    { EVENT_FEED,          ANY_STATE,                                                                             STATE_EAT },
+    { EVENT_SLEEP_TIMEOUT, stateBit(STATE_IDLE) | stateBit(STATE_WALK),                                           STATE_SLEEP },
+    { EVENT_BUMP,          stateBit(STATE_WALK),                                                                  STATE_TRIP },
+};
+
+constexpr bool validStateTable() {
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        const StateDef& d = stateTable[i];
+        int lastAnim = d.anim + ((d.flags & STATE_FLAG_DIRECTIONAL) ? 1 : 0);
+        if (d.state != i || d.interval == 0 || lastAnim >= ANIM_COUNT) return false;
+        if (d.onComplete < 0 || d.onComplete >= STATE_COUNT) return false;
+    }
+    return true;
+}
+
+constexpr bool validTransitionTable() {
+    for (const Transition& t : transitionTable) {
+        if (t.event < 0 || t.event >= EVENT_COUNT) return false;
+        if (t.from == 0 || (t.from & ~ANY_STATE) != 0) return false;
+        if (t.to < 0 || t.to >= STATE_COUNT) return false;
+    }
+    return true;
+}
+
+constexpr bool allStatesReachable() {
+    unsigned seen = stateBit(STATE_IDLE);
+    for (int pass = 0; pass < STATE_COUNT; ++pass) {
+        for (const Transition& t : transitionTable)
+            if (t.from & seen) seen |= stateBit(t.to);
+        for (const StateDef& d : stateTable)
+            if (seen & stateBit(d.state)) seen |= stateBit(d.onComplete);
+    }
+    return seen == ANY_STATE;
+}
+
+static_assert(validStateTable(), "stateTable rows must follow PetState order with a real animation, interval and exit");
+static_assert(validTransitionTable(), "transitionTable rows need a known event, a non-empty guard and a real target");
+static_assert(allStatesReachable(), "every state needs a path from STATE_IDLE");
+
+struct PetMachine {
+    PetState state = STATE_IDLE;
+    PetState previous = STATE_IDLE;
+    bool facingRight = true;
+    bool restart = true;     // rewind the animation on the next tick
+    uint32_t lastAnimationTime = 0;
+};
+
+inline PetAnim currentAnim(const PetMachine& m) {
+    const StateDef& def = stateTable[m.state];
+    bool right = (def.flags & STATE_FLAG_DIRECTIONAL) && m.facingRight;
+    return PetAnim(def.anim + (right ? 1 : 0));
+}
+
+inline void enterState(PetMachine& m, PetState next) {
+    m.previous = m.state;
+    m.state = next;
+    m.restart = true;
+}
+
+inline void setFacing(PetMachine& m, bool right) {
+    if (m.facingRight == right) return;
+    m.facingRight = right;
+    if (stateTable[m.state].flags & STATE_FLAG_DIRECTIONAL) m.restart = true;
+}
+
+// Movement is integrated by the world between frames, not per frame.
+inline bool isMoving(const PetMachine& m) {
+    return (stateTable[m.state].flags & STATE_FLAG_MOVES) != 0;
+}
+
+// Timer period the host should use right now: states flagged LOW_RATE only
+// need waking once per frame, everything else runs at the base rate.
+inline unsigned tickIntervalFor(const PetMachine& m, unsigned baseInterval) {
+    const StateDef& def = stateTable[m.state];
+    return (def.flags & STATE_FLAG_LOW_RATE) ? def.interval : baseInterval;
+}
+
+// Returns true when the current state accepted the event.
+inline bool firePetEvent(PetMachine& m, PetEvent e) {
+    for (const Transition& t : transitionTable) {
+        if (t.event == e && (t.from & stateBit(m.state))) {
+            enterState(m, t.to);
+            return true;
+        }
+    }
+    return false;
+}
+
+// One tick of the interpreter. `player` drives the actual frames:
+//   void restart(PetAnim)  - show frame 0
+//   bool advance(PetAnim)  - show the next frame, true once it wrapped
+template <typename Player>
+unsigned tickPetMachine(PetMachine& m, uint32_t now, Player& player) {
+    if (m.restart) {
+        m.restart = false;
+        player.restart(currentAnim(m));
+    }
+
+    const StateDef& def = stateTable[m.state];
+    if (now - m.lastAnimationTime + tickSlack < def.interval) return EFFECT_NONE;
+    m.lastAnimationTime = now;
+
+    unsigned effects = EFFECT_NONE;
+    bool done = player.advance(currentAnim(m));
+    if (done) {
+        if (def.flags & STATE_FLAG_ENDS_FEEDING) effects |= EFFECT_FEED_DONE;
+        if (def.onComplete != m.state) {
+            enterState(m, def.onComplete);
+            effects |= EFFECT_ENTERED;
+        }
+    }
+    return effects;
+}
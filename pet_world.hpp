@@ -0,0 +1,251 @@
+#pragma once
+
+// Every pet on screen, stored as parallel component arrays indexed by pet
+// slot so one tick walks a few tight arrays instead of N scattered objects.
+// Species metadata (frame counts, size) is shared by index; the decoded
+// frames themselves live with the host and are shared the same way.
+// Walking is simulated on a fixed timestep with fractional positions and
+// shown interpolated, so speed no longer depends on frame or timer rate.
+// Portable: a world can be built and ticked without any windows.
+
+#include "display_geometry.hpp"
+#include "motion.hpp"
+#include "pet_fsm.hpp"
+#include "spatial_grid.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SpeciesInfo {
+    std::string name;
+    int width = 0, height = 0;
+    uint16_t frameCount[ANIM_COUNT] = {};
+};
+
+// Advances one pet's frame index against its species' frame counts.
+struct FrameCounter {
+    const SpeciesInfo& species;
+    uint16_t& frame;
+
+    void restart(PetAnim) { frame = 0; }
+
+    bool advance(PetAnim anim) {
+        if (++frame < species.frameCount[anim]) return false;
+        frame = 0;
+        return true;
+    }
+};
+
+// The old walk moved 8 px every 150 ms frame.
+constexpr float defaultWalkSpeed = 8.0f * 1000 / animIntervalWalk; // px per second
+
+class PetWorld {
+public:
+    std::vector<SpeciesInfo> speciesInfo;
+
+    // Per-pet components; index i in each array is the same pet.
+    std::vector<PetMachine> machine;
+    std::vector<uint16_t> frame;
+    std::vector<uint16_t> species;
+    std::vector<int> x, y;          // where the pet is shown
+    std::vector<float> posX, prevX; // simulated x after the last two motion steps
+    std::vector<uint32_t> sleepAt;
+    std::vector<uint8_t> sleepArmed;
+
+    // Pet footprints, kept in step with x/y; slot i is grid id i.
+    SpatialGrid grid;
+
+    // Screen edges walking pets stop at; no limits when null.
+    const DisplayGeometry* display = nullptr;
+
+    float walkSpeed = defaultWalkSpeed;
+    MotionClock clock;
+
+    size_t size() const { return machine.size(); }
+
+    int findSpecies(const std::string& name) const {
+        for (size_t i = 0; i < speciesInfo.size(); ++i)
+            if (speciesInfo[i].name == name) return (int)i;
+        return -1;
+    }
+
+    uint16_t addSpecies(SpeciesInfo info) {
+        speciesInfo.push_back(std::move(info));
+        return (uint16_t)(speciesInfo.size() - 1);
+    }
+
+    size_t spawn(uint16_t speciesIndex, int px, int py) {
+        machine.emplace_back();
+        frame.push_back(0);
+        species.push_back(speciesIndex);
+        x.push_back(px);
+        y.push_back(py);
+        posX.push_back((float)px);
+        prevX.push_back((float)px);
+        sleepAt.push_back(0);
+        sleepArmed.push_back(0);
+        grid.insert(footprint(size() - 1));
+        return size() - 1;
+    }
+
+    // Swap-removes pet i. The last pet takes over slot i, so callers keeping
+    // per-pet data of their own must mirror the move.
+    void despawn(size_t i) {
+        size_t last = size() - 1;
+        if (i != last) {
+            machine[i] = machine[last];
+            frame[i] = frame[last];
+            species[i] = species[last];
+            x[i] = x[last];
+            y[i] = y[last];
+            posX[i] = posX[last];
+            prevX[i] = prevX[last];
+            sleepAt[i] = sleepAt[last];
+            sleepArmed[i] = sleepArmed[last];
+        }
+        machine.pop_back();
+        frame.pop_back();
+        species.pop_back();
+        x.pop_back();
+        y.pop_back();
+        posX.pop_back();
+        prevX.pop_back();
+        sleepAt.pop_back();
+        sleepArmed.pop_back();
+        grid.remove((uint32_t)i);
+    }
+
+    const SpeciesInfo& speciesOf(size_t i) const { return speciesInfo[species[i]]; }
+
+    Bounds footprint(size_t i) const {
+        const SpeciesInfo& s = speciesOf(i);
+        return boundsAt(x[i], y[i], s.width, s.height);
+    }
+
+    // A walking pet that reaches the edge of its monitor trips and turns round.
+    void stopAtEdge(size_t i) {
+        if (!display) return;
+        Bounds area = display->walkArea(footprint(i));
+        if (area.empty()) return;
+        int width = speciesOf(i).width;
+        bool hitLeft = posX[i] < area.left;
+        bool hitRight = posX[i] + width > area.right;
+        if (!hitLeft && !hitRight) return;
+        posX[i] = prevX[i] = (float)(hitRight ? area.right - width : area.left);
+        setFacing(machine[i], hitLeft);
+        firePetEvent(machine[i], EVENT_BUMP);
+    }
+
+    // Pulls every pet back onto a monitor after the layout changed.
+    void fitToDisplay() {
+        if (!display) return;
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            Bounds b = display->keepOnScreen(footprint(i));
+            x[i] = b.left;
+            y[i] = b.top;
+            posX[i] = prevX[i] = (float)b.left;
+            grid.move((uint32_t)i, b);
+        }
+    }
+
+    // A walking pet that runs into another turns to walk away from it.
+    void avoidNeighbours(size_t i) {
+        const Bounds& me = grid.boundsOf((uint32_t)i);
+        int centre = me.left + me.width() / 2;
+        grid.query(me, [&](uint32_t other) {
+            if (other == i) return;
+            const Bounds& b = grid.boundsOf(other);
+            setFacing(machine[i], centre >= b.left + b.width() / 2);
+        });
+    }
+
+    // Runs `steps` fixed motion steps. Velocity is constant between ticks,
+    // so the steps collapse to one multiply: posX ends `steps` steps on and
+    // prevX one step behind it.
+    void integrate(unsigned steps) {
+        if (steps == 0) return;
+        float stepDistance = walkSpeed * motionStepMs / 1000.0f;
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            if (!isMoving(machine[i])) {
+                prevX[i] = posX[i];
+                continue;
+            }
+            float v = machine[i].facingRight ? stepDistance : -stepDistance;
+            prevX[i] = posX[i] + v * (steps - 1);
+            posX[i] += v * steps;
+            stopAtEdge(i);
+        }
+    }
+
+    // Shows every pet `alpha` of the way from its previous to its latest
+    // simulated position; the grid only hears about whole-pixel moves.
+    void present(float alpha) {
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            int shown = (int)std::floor(prevX[i] + (posX[i] - prevX[i]) * alpha + 0.5f);
+            if (shown == x[i]) continue;
+            x[i] = shown;
+            grid.move((uint32_t)i, footprint(i));
+            if (isMoving(machine[i])) avoidNeighbours(i);
+        }
+    }
+
+    // Runs every pet's state machine, then moves walking pets by the time
+    // since the last tick. Returns the union of all effects so the host can
+    // react once per tick.
+    unsigned tick(uint32_t now) {
+        unsigned all = EFFECT_NONE;
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            FrameCounter counter{ speciesInfo[species[i]], frame[i] };
+            all |= tickPetMachine(machine[i], now, counter);
+        }
+        integrate(clock.advance(now));
+        present(clock.alpha());
+        return all;
+    }
+
+    // The shared timer runs as fast as the most demanding pet needs.
+    unsigned tickInterval(unsigned baseInterval) const {
+        unsigned best = 0;
+        for (const PetMachine& m : machine) {
+            unsigned interval = tickIntervalFor(m, baseInterval);
+            if (best == 0 || interval < best) best = interval;
+        }
+        return best ? best : baseInterval;
+    }
+
+    // Topmost (last spawned) pet whose bounds contain the point, or -1.
+    int hitTest(int px, int py) const { return grid.hitTest(px, py); }
+
+    void armSleep(size_t i, uint32_t now, uint32_t timeout) {
+        sleepAt[i] = now + timeout;
+        sleepArmed[i] = 1;
+    }
+
+    // Delay until the earliest armed sleep deadline; false when none is armed.
+    bool nextSleepDelay(uint32_t now, uint32_t& delay) const {
+        bool any = false;
+        delay = 0;
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            if (!sleepArmed[i]) continue;
+            int32_t left = (int32_t)(sleepAt[i] - now);
+            uint32_t d = left > 0 ? (uint32_t)left : 0;
+            if (!any || d < delay) delay = d;
+            any = true;
+        }
+        return any;
+    }
+
+    // Sends EVENT_SLEEP_TIMEOUT to every pet whose deadline has passed. Pets
+    // too busy to fall asleep get another full timeout.
+    void expireSleepDeadlines(uint32_t now, uint32_t timeout) {
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            if (!sleepArmed[i] || (int32_t)(now - sleepAt[i]) < 0) continue;
+            sleepArmed[i] = 0;
+            if (!firePetEvent(machine[i], EVENT_SLEEP_TIMEOUT) && machine[i].state != STATE_SLEEP)
+                armSleep(i, now, timeout);
+        }
+    }
+};
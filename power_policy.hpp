@@ -0,0 +1,70 @@
+#pragma once
+
+// Decides how hard the pet may work given what the machine is doing. The
+// host translates OS notifications (power source, session lock, display
+// state, fullscreen apps) into PowerEvents; the policy folds them into a
+// mode and a tick period. No Win32 in here, so a recorded sequence of
+// events can be replayed anywhere.
+
+#include <cstddef>
+
+enum PowerMode {
+    POWER_NORMAL,
+    POWER_REDUCED,   // still animating, at a lower rate
+    POWER_SUSPENDED  // nothing visible: stop ticking entirely
+};
+
+enum PowerSignal {
+    SIGNAL_ON_BATTERY,
+    SIGNAL_SESSION_LOCKED,
+    SIGNAL_DISPLAY_OFF,
+    SIGNAL_FULLSCREEN_APP,
+    SIGNAL_COUNT
+};
+
+struct PowerEvent {
+    PowerSignal signal;
+    bool active;
+};
+
+// Shortest tick period while reduced, so the fastest the pet runs; 50 ms
+// still lands walk (150 ms) and idle (250 ms) frames on tick boundaries.
+constexpr unsigned reducedTickInterval = 50;
+
+class PowerPolicy {
+public:
+    // Returns true when the event changed the mode.
+    bool apply(PowerEvent e) {
+        PowerMode before = mode();
+        unsigned bit = 1u << e.signal;
+        active = e.active ? (active | bit) : (active & ~bit);
+        return mode() != before;
+    }
+
+    bool replay(const PowerEvent* events, size_t count) {
+        bool changed = false;
+        for (size_t i = 0; i < count; ++i) changed |= apply(events[i]);
+        return changed;
+    }
+
+    bool has(PowerSignal s) const { return (active & (1u << s)) != 0; }
+
+    PowerMode mode() const {
+        if (has(SIGNAL_SESSION_LOCKED) || has(SIGNAL_DISPLAY_OFF) || has(SIGNAL_FULLSCREEN_APP))
+            return POWER_SUSPENDED;
+        if (has(SIGNAL_ON_BATTERY)) return POWER_REDUCED;
+        return POWER_NORMAL;
+    }
+
+    // Timer period for a pet that would like `wanted` ms; 0 means stop.
+    unsigned tickInterval(unsigned wanted) const {
+        switch (mode()) {
+        case POWER_SUSPENDED: return 0;
+        case POWER_REDUCED: return wanted > reducedTickInterval ? wanted : reducedTickInterval;
+        default: return wanted;
+        }
+    }
+
+private:
+    unsigned active = 0;
+};
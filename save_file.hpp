@@ -0,0 +1,86 @@
+#pragma once
+
+// Framing for data.json so a torn or half-written save is detected instead
+// of thrown at the JSON parser. A saved file is one header line followed by
+// the JSON payload:
+//
+//     #pokebuddy-save 1 <crc32 of payload, 8 hex digits> <payload length>
+//
+// The host writes the frame to a temporary file and swaps it in, keeping
+// the previous save as a backup; the loader checks the frame and falls
+// back to the backup when it does not add up. Files without a header are
+// saves from before this format and are passed through as they are.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+constexpr unsigned saveFrameVersion = 1;
+constexpr char saveFrameTag[] = "#pokebuddy-save ";
+
+struct Crc32Table {
+    uint32_t entries[256];
+    constexpr Crc32Table() : entries() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+    }
+};
+constexpr Crc32Table crc32Table;
+
+inline uint32_t crc32(const char* data, size_t size) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i)
+        c = crc32Table.entries[(c ^ (unsigned char)data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+constexpr size_t saveHeaderMax = 64;
+
+// Writes the header line for `payload` into `header`; returns its length.
+// The file is the header followed by the payload, written as two pieces so
+// the payload never has to be copied behind it.
+inline size_t saveFrameHeader(const char* payload, size_t size, char (&header)[saveHeaderMax]) {
+    int n = std::snprintf(header, saveHeaderMax, "%s%u %08x %zu\n", saveFrameTag, saveFrameVersion,
+        (unsigned)crc32(payload, size), size);
+    return n > 0 ? (size_t)n : 0;
+}
+
+enum SaveCheck {
+    SAVE_OK,      // framed and intact
+    SAVE_LEGACY,  // no header: an old save, taken as is
+    SAVE_CORRUPT  // header present but the payload is torn or altered
+};
+
+// Finds the JSON payload inside a file's bytes.
+inline SaveCheck unframeSave(const char* data, size_t size, const char*& payload, size_t& payloadSize) {
+    size_t tagLength = sizeof(saveFrameTag) - 1;
+    size_t probe = size < tagLength ? size : tagLength;
+    if (size == 0) return SAVE_CORRUPT;
+    if (std::memcmp(data, saveFrameTag, probe) != 0) {
+        payload = data;
+        payloadSize = size;
+        return SAVE_LEGACY;
+    }
+    if (size < tagLength) return SAVE_CORRUPT; // torn inside the header
+
+    const char* end = (const char*)std::memchr(data, '\n', size < saveHeaderMax ? size : saveHeaderMax);
+    if (!end) return SAVE_CORRUPT;
+    char header[saveHeaderMax];
+    std::memcpy(header, data, (size_t)(end - data));
+    header[end - data] = '\0';
+
+    unsigned version = 0, checksum = 0;
+    unsigned long long length = 0;
+    if (std::sscanf(header + tagLength, "%u %8x %llu", &version, &checksum, &length) != 3) return SAVE_CORRUPT;
+    if (version != saveFrameVersion) return SAVE_CORRUPT;
+
+    payload = end + 1;
+    payloadSize = size - (size_t)(payload - data);
+    if (length != payloadSize || crc32(payload, payloadSize) != checksum) return SAVE_CORRUPT;
+    return SAVE_OK;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// The JSON type for save documents. With nlohmann::json every node, map
+// entry and string object is its own heap allocation; SaveJson takes them
+// from one arena instead, which a SaveArenaScope opens around a load or a
+// save and frees in one go when the outermost scope closes. A SaveJson must
+// be destroyed before its scope ends (declare the scope first). Objects are
+// FlatMaps, so a small object is one block, searched and dumped in key order.
+//
+// Strings stay std::string: the save's keys and values fit its small-string
+// buffer, and the rest of the program keeps passing std::string around.
+
+#include "arena.hpp"
+#include "flat_map.hpp"
+#include "json.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+// Sized so a typical save fits the first block, which is kept across resets.
+inline Arena saveArena(16 * 1024);
+inline int saveArenaDepth = 0;
+
+class SaveArenaScope {
+public:
+    SaveArenaScope() { ++saveArenaDepth; }
+    ~SaveArenaScope() {
+        if (--saveArenaDepth == 0) saveArena.reset();
+    }
+    SaveArenaScope(const SaveArenaScope&) = delete;
+    SaveArenaScope& operator=(const SaveArenaScope&) = delete;
+};
+
+// Stateless, as basic_json default-constructs its allocators. Freeing is a
+// no-op; the memory goes back when the arena is reset.
+template <typename T>
+struct SaveAllocator {
+    using value_type = T;
+
+    SaveAllocator() = default;
+    template <typename U>
+    SaveAllocator(const SaveAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (saveArenaDepth == 0 || n > (size_t)-1 / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(saveArena.allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) noexcept {}
+};
+
+template <typename T, typename U>
+bool operator==(const SaveAllocator<T>&, const SaveAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const SaveAllocator<T>&, const SaveAllocator<U>&) { return false; }
+
+using SaveJson = nlohmann::basic_json<FlatMap, std::vector, std::string, bool,
+    std::int64_t, std::uint64_t, double, SaveAllocator>;
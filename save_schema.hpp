@@ -0,0 +1,75 @@
+#pragma once
+
+// Versions of the data.json layout and the migrations between them. A
+// save is upgraded one version at a time until it matches
+// saveSchemaVersion; a current save skips all of it after one lookup.
+//
+//   1  (no "version" key)  pokemon, posX, posY, exploreMode, bag
+//   2  version, pet { species, x, y }, exploreMode, bag
+//
+// To change the layout: bump saveSchemaVersion, append the step from the
+// previous version to saveMigrations, and describe it above.
+
+#include "save_file.hpp"
+#include "save_json.hpp"
+
+#include <cstddef>
+
+constexpr int saveSchemaVersion = 2;
+
+using SaveMigration = void (*)(SaveJson&);
+
+// Groups the first pet's fields so more pets and per-pet data can follow.
+inline void migrateSaveV1ToV2(SaveJson& j) {
+    SaveJson pet = SaveJson::object();
+    if (j.contains("pokemon")) pet["species"] = j["pokemon"];
+    if (j.contains("posX")) pet["x"] = j["posX"];
+    if (j.contains("posY")) pet["y"] = j["posY"];
+    j.erase("pokemon");
+    j.erase("posX");
+    j.erase("posY");
+    j["pet"] = std::move(pet);
+}
+
+// saveMigrations[i] upgrades version i + 1 to i + 2.
+constexpr SaveMigration saveMigrations[] = {
+    migrateSaveV1ToV2,
+};
+static_assert(sizeof(saveMigrations) / sizeof(saveMigrations[0]) == saveSchemaVersion - 1,
+    "every schema version needs a migration from the one before");
+
+// 1 for saves from before versioning, 0 when the field is not a version.
+inline int saveVersionOf(const SaveJson& j) {
+    auto it = j.find("version");
+    if (it == j.end()) return 1;
+    return it->is_number_integer() ? it->get<int>() : 0;
+}
+
+// Written by a newer build. Such a save is read for the fields this build
+// knows, and must not be written back: that would drop the rest.
+inline bool isNewerSave(const SaveJson& j) { return saveVersionOf(j) > saveSchemaVersion; }
+
+// Brings a parsed save up to saveSchemaVersion. Newer saves are left alone
+// (see isNewerSave). False when the version is unusable.
+inline bool migrateSave(SaveJson& j) {
+    int version = saveVersionOf(j);
+    if (version == saveSchemaVersion) return true;
+    if (version < 1) return false;
+    if (version > saveSchemaVersion) return true;
+    for (; version < saveSchemaVersion; ++version) saveMigrations[version - 1](j);
+    j["version"] = saveSchemaVersion;
+    return true;
+}
+
+// Checks the frame around a save file's bytes, parses the payload and
+// brings it to the current schema; false if it is torn, not a JSON object
+// or of an unusable version. Needs an open SaveArenaScope.
+inline bool parseSave(const char* data, size_t size, SaveJson& j) {
+    const char* payload;
+    size_t payloadSize;
+    if (unframeSave(data, size, payload, payloadSize) == SAVE_CORRUPT) return false;
+    // A pointer range parses through json's contiguous-bytes input adapter,
+    // which builds keys and strings straight from the file's bytes.
+    j = SaveJson::parse(payload, payload + payloadSize, nullptr, false);
+    return !j.is_discarded() && j.is_object() && migrateSave(j);
+}
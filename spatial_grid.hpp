@@ -0,0 +1,140 @@
+#pragma once
+
+// Uniform grid over pet bounding boxes. Each pet is listed in every cell its
+// bounds touch; with cells a bit larger than a pet that is at most four
+// cells, so point and neighbourhood queries only look at a handful of
+// entries no matter how many pets exist. Moving a pet only touches the
+// cell lists when it crosses a cell boundary.
+
+#include "geometry.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class SpatialGrid {
+public:
+    explicit SpatialGrid(int cellSize = 64) : cellSize(cellSize) {}
+
+    size_t size() const { return bounds.size(); }
+    const Bounds& boundsOf(uint32_t id) const { return bounds[id]; }
+
+    // Ids are dense: the next id is always size().
+    void insert(const Bounds& b) {
+        uint32_t id = (uint32_t)bounds.size();
+        bounds.push_back(b);
+        ranges.push_back(rangeOf(b));
+        stamps.push_back(0);
+        link(id, ranges[id]);
+    }
+
+    void move(uint32_t id, const Bounds& b) {
+        bounds[id] = b;
+        CellRange next = rangeOf(b);
+        if (next == ranges[id]) return;
+        unlink(id, ranges[id]);
+        ranges[id] = next;
+        link(id, next);
+    }
+
+    // Swap-removes like PetWorld::despawn: the last id is renumbered to `id`.
+    void remove(uint32_t id) {
+        uint32_t last = (uint32_t)bounds.size() - 1;
+        unlink(id, ranges[id]);
+        if (id != last) {
+            unlink(last, ranges[last]);
+            bounds[id] = bounds[last];
+            ranges[id] = ranges[last];
+            link(id, ranges[id]);
+        }
+        bounds.pop_back();
+        ranges.pop_back();
+        stamps.pop_back();
+    }
+
+    // Highest id whose bounds contain the point (the most recently added pet
+    // is drawn on top), or -1.
+    int hitTest(int x, int y) const {
+        auto cell = cells.find(key(cellOf(x), cellOf(y)));
+        if (cell == cells.end()) return -1;
+        int best = -1;
+        for (uint32_t id : cell->second)
+            if ((int)id > best && bounds[id].contains(x, y)) best = (int)id;
+        return best;
+    }
+
+    // Calls visit(id) once for every entry whose bounds intersect `area`.
+    template <typename Visit>
+    void query(const Bounds& area, Visit&& visit) const {
+        if (area.empty()) return;
+        if (++queryStamp == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            queryStamp = 1;
+        }
+        uint32_t stamp = queryStamp;
+        CellRange r = rangeOf(area);
+        for (int cy = r.y0; cy <= r.y1; ++cy) {
+            for (int cx = r.x0; cx <= r.x1; ++cx) {
+                auto cell = cells.find(key(cx, cy));
+                if (cell == cells.end()) continue;
+                for (uint32_t id : cell->second) {
+                    if (stamps[id] == stamp || !intersects(bounds[id], area)) continue;
+                    stamps[id] = stamp;
+                    visit(id);
+                }
+            }
+        }
+    }
+
+private:
+    struct CellRange {
+        int x0, y0, x1, y1;
+        bool operator==(const CellRange& o) const {
+            return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1;
+        }
+    };
+
+    int cellOf(int v) const {
+        // Floor division so negative (left/upper monitor) coordinates work.
+        return v >= 0 ? v / cellSize : -((-v + cellSize - 1) / cellSize);
+    }
+
+    CellRange rangeOf(const Bounds& b) const {
+        return { cellOf(b.left), cellOf(b.top), cellOf(b.right - 1), cellOf(b.bottom - 1) };
+    }
+
+    // Cell coordinates go in as unsigned: shifting a negative cy is undefined.
+    static uint64_t key(int cx, int cy) {
+        return ((uint64_t)(uint32_t)cy << 32) | (uint32_t)cx;
+    }
+
+    // Empty cell lists are kept so a pet walking back and forth reuses them.
+    void link(uint32_t id, const CellRange& r) {
+        for (int cy = r.y0; cy <= r.y1; ++cy)
+            for (int cx = r.x0; cx <= r.x1; ++cx)
+                cells[key(cx, cy)].push_back(id);
+    }
+
+    void unlink(uint32_t id, const CellRange& r) {
+        for (int cy = r.y0; cy <= r.y1; ++cy) {
+            for (int cx = r.x0; cx <= r.x1; ++cx) {
+                std::vector<uint32_t>& list = cells[key(cx, cy)];
+                for (size_t i = 0; i < list.size(); ++i) {
+                    if (list[i] != id) continue;
+                    list[i] = list.back();
+                    list.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+
+    int cellSize;
+    std::vector<Bounds> bounds;
+    std::vector<CellRange> ranges;
+    mutable std::vector<uint32_t> stamps;
+    mutable uint32_t queryStamp = 0;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+};
@@ -0,0 +1,76 @@
+// JSON objects backed by std::map (nlohmann::json), ordered_map
+// (nlohmann::ordered_json) and FlatMap, with and without the save arena,
+// for objects of 4 to 1000 keys: inserting keys in random and in sorted
+// order, looking every key up, and iterating. Best of several rounds, in
+// ns per key.
+
+#include "save_json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using FlatJson = nlohmann::basic_json<FlatMap>;
+
+static double nsSince(Clock::time_point start, long keys) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / keys;
+}
+
+static volatile long sink;
+
+template <typename Json>
+static void bench(const char* name, int count) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < count; ++i) keys.push_back("item-" + std::to_string(i * 7919 % 100000));
+    std::vector<std::string> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+
+    int objects = 400000 / count;
+    long total = (long)objects * count;
+    double insert = 1e300, inOrder = 1e300, lookup = 1e300, iterate = 1e300;
+    for (int round = 0; round < 5; ++round) {
+        SaveArenaScope arenaScope;
+        std::vector<Json> docs;
+        docs.reserve(objects);
+        Clock::time_point start = Clock::now();
+        for (int o = 0; o < objects; ++o) {
+            Json doc = Json::object();
+            for (const std::string& key : keys) doc[key] = o;
+            docs.push_back(std::move(doc));
+        }
+        insert = std::min(insert, nsSince(start, total));
+
+        start = Clock::now();
+        for (int o = 0; o < objects; ++o) {
+            Json doc = Json::object();
+            for (const std::string& key : sorted) doc[key] = o;
+            sink = sink + (long)doc.size();
+        }
+        inOrder = std::min(inOrder, nsSince(start, total));
+
+        start = Clock::now();
+        for (const Json& doc : docs)
+            for (const std::string& key : keys) sink = sink + doc.find(key)->template get<int>();
+        lookup = std::min(lookup, nsSince(start, total));
+
+        start = Clock::now();
+        for (const Json& doc : docs)
+            for (auto it = doc.begin(); it != doc.end(); ++it) sink = sink + (long)it.key().size();
+        iterate = std::min(iterate, nsSince(start, total));
+    }
+    std::printf("  %-16s %8.1f %9.1f %8.1f %8.1f\n", name, insert, inOrder, lookup, iterate);
+}
+
+int main() {
+    for (int count : { 4, 8, 64, 1000 }) {
+        std::printf("%d keys: %9s %9s %8s %8s\n", count, "insert", "in order", "lookup", "iterate");
+        bench<nlohmann::json>("std::map", count);
+        bench<nlohmann::ordered_json>("ordered_map", count);
+        bench<FlatJson>("FlatMap", count);
+        bench<SaveJson>("FlatMap + arena", count);
+    }
+    return 0;
+}
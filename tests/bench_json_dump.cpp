@@ -0,0 +1,222 @@
+// json.hpp's number formatting before and after the short-decimal and
+// backward-integer changes, on 200k values of each kind the save writes.
+// Doubles: the old path (Grisu2 and format_buffer, called directly) against
+// to_chars(), which tries format_short_decimal() first. Integers: the old
+// dump_integer(), copied below as it was, against serializer::dump(), each
+// behind the same switch on the value type. Both sides write through the
+// same output adapter into one reused string. Best of several rounds, in ms, with the
+// count of values whose text differs.
+
+#include "json.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using nlohmann::json;
+namespace dtoa = nlohmann::detail::dtoa_impl;
+
+template <typename Run>
+static double bestMs(Run&& run) {
+    double best = 1e300;
+    for (int round = 0; round < 15; ++round) {
+        Clock::time_point start = Clock::now();
+        run();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+// to_chars() as it was before format_short_decimal().
+static char* oldToChars(char* first, double value) {
+    if (std::signbit(value)) {
+        value = -value;
+        *first++ = '-';
+    }
+    if (value == 0) {
+        *first++ = '0';
+        *first++ = '.';
+        *first++ = '0';
+        return first;
+    }
+    int len = 0;
+    int decimalExponent = 0;
+    dtoa::grisu2(first, len, decimalExponent, value);
+    return dtoa::format_buffer(first, len, decimalExponent, -4, std::numeric_limits<double>::digits10);
+}
+
+// The old dump_integer(): counts the digits, then fills the buffer from
+// that offset backwards.
+static unsigned countDigits(uint64_t x) {
+    unsigned n = 1;
+    for (;;) {
+        if (x < 10) return n;
+        if (x < 100) return n + 1;
+        if (x < 1000) return n + 2;
+        if (x < 10000) return n + 3;
+        x = x / 10000u;
+        n += 4;
+    }
+}
+
+static void oldDumpInteger(nlohmann::detail::output_adapter_t<char>& o, std::array<char, 64>& buffer, int64_t x) {
+    static const char digits[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    if (x == 0) {
+        o->write_character('0');
+        return;
+    }
+    char* p = buffer.data();
+    uint64_t abs;
+    unsigned n;
+    if (x < 0) {
+        *p = '-';
+        abs = 0 - (uint64_t)x;
+        n = 1 + countDigits(abs);
+    } else {
+        abs = (uint64_t)x;
+        n = countDigits(abs);
+    }
+    p += n;
+    while (abs >= 100) {
+        unsigned i = (unsigned)(abs % 100) * 2;
+        abs /= 100;
+        *--p = digits[i + 1];
+        *--p = digits[i];
+    }
+    if (abs >= 10) {
+        unsigned i = (unsigned)abs * 2;
+        *--p = digits[i + 1];
+        *--p = digits[i];
+    } else {
+        *--p = (char)('0' + abs);
+    }
+    o->write_characters(buffer.data(), n);
+}
+
+// The text of every value, separated by spaces, so the two sides can be
+// compared.
+template <typename Write>
+static std::string allText(size_t count, Write&& write) {
+    std::string text;
+    auto o = nlohmann::detail::output_adapter<char>(text).operator nlohmann::detail::output_adapter_t<char>();
+    for (size_t i = 0; i < count; ++i) {
+        write(o, i);
+        o->write_character(' ');
+    }
+    return text;
+}
+
+static size_t differences(const std::string& a, const std::string& b) {
+    size_t count = 0, i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        size_t ai = a.find(' ', i), bj = b.find(' ', j);
+        count += a.compare(i, ai - i, b, j, bj - j) != 0;
+        i = ai + 1;
+        j = bj + 1;
+    }
+    return count;
+}
+
+static void benchDoubles(const char* name, const std::vector<double>& values) {
+    auto oldWrite = [&](nlohmann::detail::output_adapter_t<char>& o, size_t i) {
+        char buffer[64];
+        o->write_characters(buffer, (size_t)(oldToChars(buffer, values[i]) - buffer));
+    };
+    auto newWrite = [&](nlohmann::detail::output_adapter_t<char>& o, size_t i) {
+        char buffer[64];
+        o->write_characters(buffer, (size_t)(nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), values[i]) - buffer));
+    };
+    size_t differ = differences(allText(values.size(), oldWrite), allText(values.size(), newWrite));
+
+    std::string text;
+    auto o = nlohmann::detail::output_adapter<char>(text).operator nlohmann::detail::output_adapter_t<char>();
+    double before = bestMs([&] {
+        text.clear();
+        for (size_t i = 0; i < values.size(); ++i) oldWrite(o, i);
+    });
+    double after = bestMs([&] {
+        text.clear();
+        for (size_t i = 0; i < values.size(); ++i) newWrite(o, i);
+    });
+    std::printf("  %-28s %8.2f %8.2f %8zu\n", name, before, after, differ);
+}
+
+static void benchIntegers(const char* name, const std::vector<int64_t>& values) {
+    std::vector<json> docs(values.begin(), values.end());
+    std::array<char, 64> buffer;
+    // The same switch on the value type as serializer::dump(), so both
+    // columns pay for it.
+    auto oldWrite = [&](nlohmann::detail::output_adapter_t<char>& o, size_t i) {
+        switch (docs[i].type()) {
+        case json::value_t::number_integer:
+            oldDumpInteger(o, buffer, docs[i].get_ref<const json::number_integer_t&>());
+            break;
+        case json::value_t::number_unsigned:
+            oldDumpInteger(o, buffer, (int64_t)docs[i].get_ref<const json::number_unsigned_t&>());
+            break;
+        default:
+            break;
+        }
+    };
+    auto newText = allText(docs.size(), [&](nlohmann::detail::output_adapter_t<char>& o, size_t i) {
+        nlohmann::detail::serializer<json>(o, ' ').dump(docs[i], false, false, 0);
+    });
+    size_t differ = differences(allText(values.size(), oldWrite), newText);
+
+    std::string text;
+    auto o = nlohmann::detail::output_adapter<char>(text).operator nlohmann::detail::output_adapter_t<char>();
+    nlohmann::detail::serializer<json> writer(o, ' ');
+    double before = bestMs([&] {
+        text.clear();
+        for (size_t i = 0; i < values.size(); ++i) oldWrite(o, i);
+    });
+    double after = bestMs([&] {
+        text.clear();
+        for (const json& j : docs) writer.dump(j, false, false, 0);
+    });
+    std::printf("  %-28s %8.2f %8.2f %8zu\n", name, before, after, differ);
+}
+
+int main() {
+    std::mt19937_64 rng(46);
+    const size_t count = 200000;
+    std::vector<double> speeds, coordinates, fullPrecision, wide;
+    for (size_t i = 0; i < count; ++i) {
+        speeds.push_back((double)(rng() % 100000) / 100);                 // 2 decimals
+        coordinates.push_back((double)(rng() % 40000) / 2 - 10000);       // halves, signed
+        fullPrecision.push_back((double)(rng() >> 11) / (double)(1ull << 53) * 1e6);
+        uint64_t bits = rng();
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        wide.push_back(std::isfinite(d) ? d : 1.0);                      // any exponent
+    }
+    std::vector<int64_t> small, mixed, negative;
+    for (size_t i = 0; i < count; ++i) {
+        small.push_back((int64_t)(rng() % 10000));
+        mixed.push_back((int64_t)(rng() >> (rng() % 64)));
+        negative.push_back(-(int64_t)(rng() >> (1 + rng() % 63)));
+    }
+
+    std::printf("  %-28s %8s %8s %8s\n", "doubles", "old ms", "new ms", "differ");
+    benchDoubles("2-decimal speeds", speeds);
+    benchDoubles("signed halves", coordinates);
+    benchDoubles("full precision < 1e6", fullPrecision);
+    benchDoubles("random bits", wide);
+    std::printf("  %-28s %8s %8s %8s\n", "integers", "old ms", "new ms", "differ");
+    benchIntegers("0 to 9999", small);
+    benchIntegers("1 to 20 digits", mixed);
+    benchIntegers("negative", negative);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// json.hpp's lexer on the documents the contiguous-input work targets: a
+// compact object array, the same indented, and a string-heavy document,
+// each about 2 MB, plus one with a syntax error at its very end so the
+// error token is built. Times json::accept and json::parse from a pointer
+// range (contiguous input) and accept through an istream (the copying
+// path). Best of several rounds, in ms. Only uses nlohmann::json, so it
+// builds against older copies of json.hpp for comparison.
+
+#include "json.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+using nlohmann::json;
+
+template <typename Run>
+static double bestMs(Run&& run) {
+    double best = 1e300;
+    for (int round = 0; round < 15; ++round) {
+        Clock::time_point start = Clock::now();
+        run();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+static json records(int count) {
+    json all = json::array();
+    for (int i = 0; i < count; ++i) {
+        all.push_back({ { "id", i }, { "species", "bulbasaur" }, { "x", i * 7 % 1920 }, { "y", 1016 },
+            { "speed", 53.333 + i % 10 }, { "asleep", i % 3 == 0 }, { "bag", { { "oran-berry", i % 5 } } } });
+    }
+    return all;
+}
+
+static std::string stringHeavy(size_t bytes) {
+    std::string text = "[";
+    for (int i = 0; text.size() < bytes; ++i) {
+        if (i) text += ',';
+        text += "\"A pet found item number " + std::to_string(i) + " while exploring the taskbar, "
+            "and it was a perfectly ordinary berry with nothing to escape\"";
+    }
+    return text + "]";
+}
+
+static volatile size_t sink;
+
+int main() {
+    std::string compact = records(16000).dump();
+    std::string docs[] = { compact, records(16000).dump(4), stringHeavy(2 << 20), compact + "," };
+    const char* names[] = { "compact", "indented", "strings", "error at end" };
+
+    std::printf("%-13s %6s  %12s %12s %12s\n", "document", "MB", "accept ptr", "accept istr", "parse ptr");
+    for (int d = 0; d < 4; ++d) {
+        const std::string& text = docs[d];
+        const char* first = text.data();
+        const char* last = first + text.size();
+        double acceptPtr = bestMs([&] { sink = sink + json::accept(first, last); });
+        double acceptStream = bestMs([&] {
+            std::istringstream in(text);
+            sink = sink + json::accept(in);
+        });
+        double parsePtr = bestMs([&] { sink = sink + json::parse(first, last, nullptr, false).size(); });
+        std::printf("%-13s %6.2f  %12.2f %12.2f %12.2f\n", names[d], text.size() / 1048576.0, acceptPtr,
+            acceptStream, parsePtr);
+    }
+    return 0;
+}
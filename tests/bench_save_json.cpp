@@ -0,0 +1,82 @@
+// A load and a save's worth of document work with SaveJson (arena-backed,
+// flat objects) against plain nlohmann::json: parse the save, migrate it,
+// then build a fresh document as serializeSave() does. Counts heap
+// allocations through a replaced operator new and reports the latency,
+// best of several rounds, for the current save and a 5000-item bag.
+
+#include "save_schema.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+static long allocations = 0;
+
+void* operator new(std::size_t bytes) {
+    ++allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using Clock = std::chrono::steady_clock;
+
+static bool migrate(SaveJson& j) { return migrateSave(j); }
+static bool migrate(nlohmann::json& j) { return j.is_object(); } // already current
+
+template <typename Json>
+static void buildSave(Json& j, int items) {
+    j["version"] = saveSchemaVersion;
+    j["pet"] = { { "species", "bulbasaur" }, { "x", 812 }, { "y", 1040 } };
+    j["exploreMode"] = true;
+    j["bag"] = Json::object();
+    char key[32];
+    for (int i = 0; i < items; ++i) {
+        std::snprintf(key, sizeof(key), "berry-%05d", i);
+        j["bag"][key] = i % 99 + 1;
+    }
+}
+
+static volatile size_t sink;
+
+template <typename Json>
+static void run(const char* name, const std::string& text, int items) {
+    double best = 1e300;
+    long counted = 0;
+    int rounds = items < 1000 ? 2000 : 100;
+    for (int round = 0; round < rounds; ++round) {
+        long before = allocations;
+        Clock::time_point start = Clock::now();
+        {
+            SaveArenaScope arenaScope;
+            Json loaded = Json::parse(text.data(), text.data() + text.size());
+            sink = sink + migrate(loaded);
+            Json saved;
+            buildSave(saved, items);
+            sink = sink + saved.size();
+        }
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        if (us < best) best = us;
+        counted = allocations - before;
+    }
+    std::printf("  %-16s %6ld allocations  %9.2f us\n", name, counted, best);
+}
+
+int main() {
+    for (int items : { 4, 5000 }) {
+        std::string text;
+        {
+            SaveArenaScope arenaScope;
+            SaveJson j;
+            buildSave(j, items);
+            text = j.dump();
+        }
+        std::printf("bag of %d (%zu bytes):\n", items, text.size());
+        run<nlohmann::json>("nlohmann::json", text, items);
+        run<SaveJson>("SaveJson", text, items);
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// Loading a save, from opening the file to a parsed document, for saves
+// from about 200 B to 50 MB, four ways:
+//   ifstream  the old loader: std::ifstream >> json, through json.hpp's
+//             input_stream_adapter, on the same save without its frame
+//   FILE*     fopen/fread into a buffer, then parseSave()
+//   read      read() into a buffer, then parseSave(); MappedFile's path for
+//             saves under mapThreshold
+//   mmap      parseSave() straight from the mapping; MappedFile's path for
+//             larger saves
+// The last three check the frame (a CRC over every byte) and parse from a
+// pointer range. POSIX calls stand in for ReadFile and MapViewOfFile. The
+// file is freshly written, so every path reads from the page cache. Best
+// of several rounds, in us.
+
+#include "save_schema.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Run>
+static double bestUs(int rounds, Run&& run) {
+    double best = 1e300;
+    for (int round = 0; round < rounds; ++round) {
+        Clock::time_point start = Clock::now();
+        run();
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        if (us < best) best = us;
+    }
+    return best;
+}
+
+// A save payload of about `bytes`, padded out with bag entries. Keys are
+// in order, as saveData() writes them.
+static std::string savePayload(size_t bytes) {
+    std::string payload = R"({"version":2,"pet":{"species":"bulbasaur","x":1200,"y":1016},"exploreMode":true,"bag":{)";
+    char entry[48];
+    for (int i = 0; payload.size() + 2 < bytes; ++i) {
+        std::snprintf(entry, sizeof(entry), "%s\"item-%08d-berry\":%d", i ? "," : "", i, i % 99 + 1);
+        payload += entry;
+    }
+    return payload + "}}";
+}
+
+static std::string framed(const std::string& payload) {
+    char header[saveHeaderMax];
+    size_t headerSize = saveFrameHeader(payload.data(), payload.size(), header);
+    return std::string(header, headerSize) + payload;
+}
+
+static void writeFile(const char* path, const std::string& bytes) {
+    FILE* out = std::fopen(path, "wb");
+    std::fwrite(bytes.data(), 1, bytes.size(), out);
+    std::fclose(out);
+}
+
+static volatile size_t sink;
+
+static void parse(const char* data, size_t size) {
+    SaveArenaScope arenaScope;
+    SaveJson j;
+    sink = sink + (parseSave(data, size, j) ? j.size() : 0);
+}
+
+static void viaIfstream(const char* path) {
+    std::ifstream in(path);
+    nlohmann::json j;
+    in >> j;
+    sink = sink + j.size();
+}
+
+static void viaFile(const char* path) {
+    FILE* file = std::fopen(path, "rb");
+    std::fseek(file, 0, SEEK_END);
+    std::string buffer((size_t)std::ftell(file), '\0');
+    std::fseek(file, 0, SEEK_SET);
+    size_t done = std::fread(&buffer[0], 1, buffer.size(), file);
+    std::fclose(file);
+    parse(buffer.data(), done);
+}
+
+static void viaRead(const char* path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    fstat(fd, &st);
+    std::string buffer((size_t)st.st_size, '\0');
+    size_t done = 0;
+    while (done < buffer.size()) {
+        ssize_t n = read(fd, &buffer[done], buffer.size() - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    close(fd);
+    parse(buffer.data(), done);
+}
+
+static void viaMap(const char* path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    fstat(fd, &st);
+    size_t size = (size_t)st.st_size;
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    parse((const char*)view, size);
+    munmap(view, size);
+    close(fd);
+}
+
+int main() {
+    const char* legacyPath = "bench_save_read_legacy.tmp";
+    const char* path = "bench_save_read.tmp";
+    std::printf("%10s  %12s %12s %12s %12s\n", "save", "ifstream", "FILE*", "read", "mmap");
+    for (size_t size : { 200u, 1u << 10, 4u << 10, 16u << 10, 64u << 10, 256u << 10, 1u << 20, 50u << 20 }) {
+        std::string payload = savePayload(size);
+        writeFile(legacyPath, payload);
+        writeFile(path, framed(payload));
+
+        int rounds = size < (64u << 10) ? 500 : size < (1u << 20) ? 20 : size < (50u << 20) ? 5 : 2;
+        double stream = bestUs(rounds, [&] { viaIfstream(legacyPath); });
+        double file = bestUs(rounds, [&] { viaFile(path); });
+        double read = bestUs(rounds, [&] { viaRead(path); });
+        double map = bestUs(rounds, [&] { viaMap(path); });
+        std::printf("%8zuB  %12.1f %12.1f %12.1f %12.1f\n", payload.size(), stream, file, read, map);
+    }
+    std::remove(legacyPath);
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Serializing a save: the old j.dump(4) into a fresh string against the
+// compact serializer bound to one reused buffer, as saveData() does now,
+// with and without the CRC frame. Bags of 4 to 5000 items. Best of several
+// rounds, in us, with the payload size.
+
+#include "save_schema.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Run>
+static double bestUs(int rounds, Run&& run) {
+    double best = 1e300;
+    for (int round = 0; round < rounds; ++round) {
+        Clock::time_point start = Clock::now();
+        run();
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        if (us < best) best = us;
+    }
+    return best;
+}
+
+static volatile size_t sink;
+
+int main() {
+    std::string buffer;
+    nlohmann::detail::serializer<SaveJson> writer(nlohmann::detail::output_adapter<char>(buffer), ' ');
+
+    std::printf("%6s  %17s  %17s  %14s\n", "items", "dump(4)", "compact", "compact+frame");
+    for (int items : { 4, 64, 1000, 5000 }) {
+        SaveArenaScope arenaScope;
+        SaveJson j;
+        j["version"] = saveSchemaVersion;
+        j["pet"] = { { "species", "bulbasaur" }, { "x", 1200 }, { "y", 1016 } };
+        j["exploreMode"] = true;
+        j["bag"] = SaveJson::object();
+        char key[32];
+        for (int i = 0; i < items; ++i) {
+            std::snprintf(key, sizeof(key), "item-%05d-berry", i);
+            j["bag"][key] = i % 99 + 1;
+        }
+
+        int rounds = items < 1000 ? 2000 : 50;
+        size_t prettySize = 0, compactSize = 0;
+        double pretty = bestUs(rounds, [&] {
+            std::string s = j.dump(4);
+            prettySize = s.size();
+        });
+        double compact = bestUs(rounds, [&] {
+            buffer.clear();
+            writer.dump(j, false, false, 0);
+            compactSize = buffer.size();
+        });
+        double framed = bestUs(rounds, [&] {
+            buffer.clear();
+            writer.dump(j, false, false, 0);
+            char header[saveHeaderMax];
+            sink = sink + saveFrameHeader(buffer.data(), buffer.size(), header);
+        });
+        std::printf("%6d  %8.2f %7zuB  %8.2f %7zuB  %14.2f\n", items, pretty, prettySize, compact, compactSize, framed);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Cursor hit tests and neighbour queries through SpatialGrid against the
+// linear scans it replaced, for 10, 100 and 1000 pets scattered over a
+// 3840x2160 desktop. Prints ns per query; best of several rounds.
+
+#include "spatial_grid.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Run>
+static double bestNsPerQuery(int queries, Run&& run) {
+    double best = 1e300;
+    for (int round = 0; round < 7; ++round) {
+        Clock::time_point start = Clock::now();
+        run();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / queries;
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+
+int main() {
+    const int queries = 200000;
+    volatile long long sink = 0;
+    std::printf("%6s  %14s %14s  %16s %16s\n", "pets", "hit grid", "hit linear", "neighbour grid", "neighbour linear");
+    for (int count : { 10, 100, 1000 }) {
+        std::mt19937 rng(count);
+        SpatialGrid grid;
+        std::vector<Bounds> pets;
+        for (int i = 0; i < count; ++i) {
+            pets.push_back(boundsAt((int)(rng() % 3776), (int)(rng() % 2096), 64, 64));
+            grid.insert(pets.back());
+        }
+        std::vector<int> points;
+        for (int i = 0; i < queries; ++i) {
+            points.push_back((int)(rng() % 3840));
+            points.push_back((int)(rng() % 2160));
+        }
+
+        double hitGrid = bestNsPerQuery(queries, [&] {
+            for (int i = 0; i < queries; ++i) sink += grid.hitTest(points[2 * i], points[2 * i + 1]);
+        });
+        double hitLinear = bestNsPerQuery(queries, [&] {
+            for (int i = 0; i < queries; ++i) {
+                int x = points[2 * i], y = points[2 * i + 1], hit = -1;
+                for (int p = count - 1; p >= 0; --p)
+                    if (pets[p].contains(x, y)) { hit = p; break; }
+                sink += hit;
+            }
+        });
+        double nearGrid = bestNsPerQuery(queries, [&] {
+            for (int i = 0; i < queries; ++i) {
+                const Bounds& me = pets[i % count];
+                grid.query(me, [&](uint32_t other) { sink += other; });
+            }
+        });
+        double nearLinear = bestNsPerQuery(queries, [&] {
+            for (int i = 0; i < queries; ++i) {
+                const Bounds& me = pets[i % count];
+                for (int p = 0; p < count; ++p)
+                    if (intersects(pets[p], me)) sink += p;
+            }
+        });
+        std::printf("%6d  %11.1f ns %11.1f ns  %13.1f ns %13.1f ns\n", count, hitGrid, hitLinear, nearGrid, nearLinear);
+    }
+    return 0;
+}
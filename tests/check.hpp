@@ -0,0 +1,34 @@
+#pragma once
+
+// Just enough of a test framework for the portable headers. CHECK and
+// CHECK_EQUAL print the failing expression with its file and line and keep
+// going; a test's main() returns checkResult(), which fails the ctest run
+// when any check did.
+
+#include <cstdio>
+
+inline int checkFailures = 0;
+
+inline void checkFailed(const char* file, int line, const char* expression) {
+    ++checkFailures;
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+}
+
+inline void checkEqualFailed(const char* file, int line, const char* expression, long long actual, long long expected) {
+    ++checkFailures;
+    std::fprintf(stderr, "%s:%d: CHECK_EQUAL(%s) failed: %lld != %lld\n", file, line, expression, actual, expected);
+}
+
+#define CHECK(expr) ((expr) ? (void)0 : checkFailed(__FILE__, __LINE__, #expr))
+
+#define CHECK_EQUAL(actual, expected)                                                   \
+    do {                                                                                \
+        long long checkActual = (long long)(actual), checkExpected = (long long)(expected); \
+        if (checkActual != checkExpected)                                               \
+            checkEqualFailed(__FILE__, __LINE__, #actual ", " #expected, checkActual, checkExpected); \
+    } while (0)
+
+inline int checkResult() {
+    if (checkFailures) std::fprintf(stderr, "%d check(s) failed\n", checkFailures);
+    return checkFailures ? 1 : 0;
+}
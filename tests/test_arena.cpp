@@ -0,0 +1,79 @@
+#include "arena.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <string>
+
+static bool same(const wchar_t* a, const wchar_t* b) { return std::wstring(a) == b; }
+
+static void testTextBuilder() {
+    TextBuilder<32> label;
+    label << L"Oran berry" << L" x " << 12;
+    CHECK(same(label.c_str(), L"Oran berry x 12"));
+    CHECK_EQUAL(label.size(), 15u);
+    CHECK(!label.truncated());
+
+    TextBuilder<32> numbers;
+    numbers << 0 << L" " << -7 << L" " << (long long)INT64_MIN;
+    CHECK(same(numbers.c_str(), L"0 -7 -9223372036854775808"));
+
+    // Text that does not fit is cut off, flagged and still terminated.
+    TextBuilder<8> small;
+    small << L"abcdefghij";
+    CHECK(small.truncated());
+    CHECK_EQUAL(small.size(), 7u);
+    CHECK(same(small.c_str(), L"abcdefg"));
+}
+
+static void testUtf8() {
+    TextBuilder<32> t;
+    t << std::string("caf\xC3\xA9 \xE2\x82\xAC");
+    CHECK(same(t.c_str(), L"caf\u00E9 \u20AC"));
+
+    // Outside the BMP: a surrogate pair where wchar_t is 16 bits.
+    TextBuilder<8> emoji;
+    emoji << std::string("\xF0\x9F\x8D\x92");
+    CHECK_EQUAL(emoji.size(), sizeof(wchar_t) == 2 ? 2u : 1u);
+
+    // Malformed, overlong and truncated sequences become U+FFFD.
+    TextBuilder<16> bad;
+    bad << std::string("a\xFF" "b\xC0\xAF" "c\xE2\x82", 8);
+    CHECK(same(bad.c_str(), L"a\uFFFDb\uFFFD\uFFFDc\uFFFD\uFFFD"));
+}
+
+static void testArena() {
+    Arena arena(256);
+    PathBuilder path;
+    path << L"assets\\berries\\" << std::string("oran-berry") << L".png";
+    const wchar_t* kept = path.keep(arena);
+    CHECK(kept != path.c_str());
+    CHECK(same(kept, L"assets\\berries\\oran-berry.png"));
+
+    // Allocations are aligned and survive new blocks being added.
+    const wchar_t* strings[100];
+    for (int i = 0; i < 100; ++i) {
+        TextBuilder<16> t;
+        t << L"item " << i;
+        strings[i] = t.keep(arena);
+        CHECK_EQUAL((uintptr_t)strings[i] % alignof(wchar_t), 0u);
+    }
+    void* big = arena.allocate(1000, 16);
+    CHECK_EQUAL((uintptr_t)big % 16, 0u);
+    for (int i = 0; i < 100; ++i) {
+        TextBuilder<16> t;
+        t << L"item " << i;
+        CHECK(same(strings[i], t.c_str()));
+    }
+    CHECK(same(kept, L"assets\\berries\\oran-berry.png"));
+
+    arena.reset();
+    const wchar_t* again = arena.copy(L"x", 1);
+    CHECK(same(again, L"x"));
+}
+
+int main() {
+    testTextBuilder();
+    testUtf8();
+    testArena();
+    return checkResult();
+}
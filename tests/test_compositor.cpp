@@ -0,0 +1,101 @@
+#include "check.hpp"
+#include "compositor.hpp"
+
+#include <random>
+
+static void testDirtyRegionMerges() {
+    DirtyRegion d;
+    d.add(Bounds{});
+    CHECK(d.empty());
+
+    d.add({ 0, 0, 10, 10 });
+    d.add({ 2, 2, 5, 5 }); // inside
+    CHECK_EQUAL(d.size(), 1u);
+    d.add({ 10, 0, 20, 10 }); // shares an edge
+    CHECK_EQUAL(d.size(), 1u);
+    CHECK(d.bounds() == (Bounds{ 0, 0, 20, 10 }));
+
+    // A rect bridging two separate ones merges all three.
+    d.add({ 40, 0, 50, 10 });
+    CHECK_EQUAL(d.size(), 2u);
+    d.add({ 15, 0, 45, 5 });
+    CHECK_EQUAL(d.size(), 1u);
+    CHECK(d.bounds() == (Bounds{ 0, 0, 50, 10 }));
+}
+
+static void testDirtyRegionStaysBounded() {
+    std::mt19937 rng(3);
+    DirtyRegion d;
+    Bounds all;
+    for (int i = 0; i < 1000; ++i) {
+        int x = (int)(rng() % 3000), y = (int)(rng() % 2000);
+        Bounds r = boundsAt(x, y, 1 + (int)(rng() % 80), 1 + (int)(rng() % 80));
+        d.add(r);
+        all = unite(all, r);
+        CHECK(d.size() <= DirtyRegion::maxRects);
+
+        // Everything added is still covered, and no two rects touch.
+        CHECK(d.bounds() == all);
+        for (const Bounds* a = d.begin(); a != d.end(); ++a)
+            for (const Bounds* b = a + 1; b != d.end(); ++b)
+                CHECK(!touches(*a, *b));
+    }
+}
+
+static void testPlannerSharesCloseTaskbarPets() {
+    CompositionPlanner planner;
+    CompositionPlan plan;
+    const Bounds strip{ 0, 1000, 1920, 1080 };
+    Bounds pets[3] = {
+        boundsAt(100, 1020, 64, 64),
+        boundsAt(150, 1020, 64, 64),
+        boundsAt(900, 100, 64, 64), // away from the taskbar
+    };
+
+    CHECK(planner.plan(pets, 3, strip, plan));
+    CHECK(plan.shared);
+    CHECK_EQUAL(plan.inShared[0], 1);
+    CHECK_EQUAL(plan.inShared[1], 1);
+    CHECK_EQUAL(plan.inShared[2], 0);
+    CHECK(plan.surface.contains(unite(pets[0], pets[1])));
+
+    // A step inside the padding keeps the surface where it is.
+    pets[0].left += 4;
+    pets[0].right += 4;
+    CHECK(!planner.plan(pets, 3, strip, plan));
+    CHECK(plan.shared);
+
+    // Spread between the enter (3x) and leave (6x) ratios: still shared.
+    pets[1] = boundsAt(600, 1020, 64, 64);
+    planner.plan(pets, 3, strip, plan);
+    CHECK(plan.shared);
+
+    // Mostly empty space: back to one window per pet.
+    pets[1] = boundsAt(1500, 1020, 64, 64);
+    CHECK(planner.plan(pets, 3, strip, plan));
+    CHECK(!plan.shared);
+    CHECK_EQUAL(plan.inShared[0], 0);
+    CHECK_EQUAL(plan.inShared[1], 0);
+
+    // ... but entering needs the tighter ratio.
+    pets[1] = boundsAt(600, 1020, 64, 64);
+    planner.plan(pets, 3, strip, plan);
+    CHECK(!plan.shared);
+}
+
+static void testPlannerNeedsTwoPets() {
+    CompositionPlanner planner;
+    CompositionPlan plan;
+    Bounds pet = boundsAt(100, 1020, 64, 64);
+    CHECK(!planner.plan(&pet, 1, Bounds{ 0, 1000, 1920, 1080 }, plan));
+    CHECK(!plan.shared);
+    CHECK_EQUAL(plan.inShared.size(), 1u);
+}
+
+int main() {
+    testDirtyRegionMerges();
+    testDirtyRegionStaysBounded();
+    testPlannerSharesCloseTaskbarPets();
+    testPlannerNeedsTwoPets();
+    return checkResult();
+}
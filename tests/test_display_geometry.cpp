@@ -0,0 +1,101 @@
+#include "check.hpp"
+#include "display_geometry.hpp"
+
+// Primary 1920x1080 with a 40 px taskbar, and a 1280x1024 monitor to its
+// left sitting 200 px higher.
+static DisplayGeometry twoMonitors() {
+    DisplayGeometry g;
+    std::vector<MonitorArea> layout(2);
+    layout[0].monitor = { 0, 0, 1920, 1080 };
+    layout[0].work = { 0, 0, 1920, 1040 };
+    layout[0].primary = true;
+    layout[1].monitor = { -1280, -200, 0, 824 };
+    layout[1].work = layout[1].monitor;
+    g.setLayout(layout, { 0, 1040, 1920, 1080 });
+    return g;
+}
+
+static void testMonitorAt() {
+    DisplayGeometry g = twoMonitors();
+    CHECK_EQUAL(g.monitorAt(0, 0), 0);
+    CHECK_EQUAL(g.monitorAt(1919, 1079), 0);
+    CHECK_EQUAL(g.monitorAt(-1, 0), 1);
+    CHECK_EQUAL(g.monitorAt(-1280, -200), 1);
+
+    // Off every monitor: the closest one wins.
+    CHECK_EQUAL(g.monitorAt(5000, 500), 0);
+    CHECK_EQUAL(g.monitorAt(-3000, 0), 1);
+    CHECK_EQUAL(g.monitorAt(-10, 1000), 0);
+    CHECK_EQUAL(g.monitorAt(-300, 900), 1);
+
+    CHECK_EQUAL(DisplayGeometry().monitorAt(0, 0), -1);
+}
+
+static void testWalkArea() {
+    DisplayGeometry g = twoMonitors();
+    // The taskbar is floor, so the area is the whole monitor.
+    CHECK(g.walkArea(boundsAt(100, 1000, 64, 64)) == g.layout()[0].monitor);
+    CHECK(g.walkArea(boundsAt(-100, 0, 64, 64)) == g.layout()[1].monitor);
+    // A pet straddling the seam belongs where its centre is.
+    CHECK(g.walkArea(boundsAt(-24, 100, 64, 64)) == g.layout()[0].monitor);
+    CHECK(g.walkArea(boundsAt(-40, 100, 64, 64)) == g.layout()[1].monitor);
+    CHECK(DisplayGeometry().walkArea(boundsAt(0, 0, 64, 64)).empty());
+}
+
+static void testKeepOnScreen() {
+    DisplayGeometry g = twoMonitors();
+    Bounds inside = boundsAt(500, 500, 64, 64);
+    CHECK(g.keepOnScreen(inside) == inside);
+
+    CHECK(g.keepOnScreen(boundsAt(1900, 1060, 64, 64)) == boundsAt(1856, 1016, 64, 64));
+    CHECK(g.keepOnScreen(boundsAt(-1300, -220, 64, 64)) == boundsAt(-1280, -200, 64, 64));
+
+    // Saved on a desktop that is gone: lands on the nearest monitor.
+    Bounds lost = g.keepOnScreen(boundsAt(4000, 300, 64, 64));
+    CHECK(g.layout()[0].monitor.contains(lost));
+    CHECK_EQUAL(lost.top, 300);
+
+    // Bigger than the monitor: the top left stays visible.
+    Bounds huge = g.keepOnScreen(boundsAt(-50, -50, 3000, 2000));
+    CHECK_EQUAL(huge.left, 0);
+    CHECK_EQUAL(huge.top, 0);
+
+    Bounds pet = boundsAt(9000, 9000, 64, 64);
+    CHECK(DisplayGeometry().keepOnScreen(pet) == pet);
+}
+
+static void testRestingSpot() {
+    DisplayGeometry g = twoMonitors();
+    CHECK(g.restingSpot(64, 64) == boundsAt(1920 - 64 - 80, 1080 - 64 + 2, 64, 64));
+
+    // No taskbar: the bottom right of the primary monitor.
+    std::vector<MonitorArea> layout = g.layout();
+    std::swap(layout[0], layout[1]);
+    DisplayGeometry noTaskbar;
+    noTaskbar.setLayout(layout, Bounds{});
+    CHECK(noTaskbar.primaryMonitor() == &noTaskbar.layout()[1]);
+    CHECK(noTaskbar.restingSpot(64, 64) == boundsAt(1920 - 64 - 80, 1080 - 64 + 2, 64, 64));
+
+    CHECK(DisplayGeometry().restingSpot(64, 64) == boundsAt(0, 0, 64, 64));
+    CHECK(DisplayGeometry().primaryMonitor() == nullptr);
+}
+
+static void testTaskbarStrip() {
+    DisplayGeometry g = twoMonitors();
+    CHECK(g.taskbarStrip(64) == Bounds({ 0, 1040 - 64, 1920, 1080 }));
+
+    DisplayGeometry noTaskbar;
+    noTaskbar.setLayout(g.layout(), Bounds{});
+    CHECK(noTaskbar.taskbarStrip(64) == Bounds({ 0, 1080 - 128, 1920, 1080 }));
+
+    CHECK(DisplayGeometry().taskbarStrip(64).empty());
+}
+
+int main() {
+    testMonitorAt();
+    testWalkArea();
+    testKeepOnScreen();
+    testRestingSpot();
+    testTaskbarStrip();
+    return checkResult();
+}
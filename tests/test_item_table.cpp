@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "item_table.hpp"
+
+#include <string>
+
+static bool same(const wchar_t* a, const wchar_t* b) { return std::wstring(a) == b; }
+
+static void testFoundItems() {
+    ItemTable items;
+    CHECK_EQUAL(items.size(), foundItemCount);
+    for (int i = 0; i < foundItemCount; ++i) {
+        CHECK_EQUAL(items.find(foundItemKeys[i]), i);
+        CHECK_EQUAL(items.intern(foundItemKeys[i]), i);
+    }
+    CHECK_EQUAL(items.size(), foundItemCount);
+
+    int sitrus = items.find("sitrus-berry");
+    CHECK(same(items.displayName(sitrus), L"Sitrus berry"));
+    CHECK(same(items.iconPath(sitrus), L"assets\\berries\\sitrus-berry.png"));
+    CHECK(same(items.eatAnimPath(sitrus), L"assets\\berries\\sitrus-berry-eat.gif"));
+    CHECK_EQUAL(items.category(sitrus), ITEM_BERRY);
+    CHECK_EQUAL(items.category(items.find("pokeball")), ITEM_BALL);
+}
+
+static void testIntern() {
+    ItemTable items;
+    CHECK_EQUAL(items.find("rare-candy"), -1);
+    int candy = items.intern("rare-candy");
+    CHECK_EQUAL(candy, foundItemCount);
+    CHECK_EQUAL(items.find("rare-candy"), candy);
+    CHECK(items.key(candy) == "rare-candy");
+    CHECK_EQUAL(items.category(candy), ITEM_OTHER);
+
+    // Keys are UTF-8 and decoded, not widened byte by byte.
+    int accented = items.intern("caf\xC3\xA9-berry");
+    CHECK(same(items.displayName(accented), L"Caf\u00E9 berry"));
+}
+
+// Only plain names get through to an asset path.
+static void testItemKeys() {
+    for (const char* key : foundItemKeys) CHECK(isItemKey(key));
+    CHECK(isItemKey("rare-candy"));
+    CHECK(isItemKey("tm_01"));
+    CHECK(isItemKey(std::string(32, 'a')));
+    const char* rejected[] = { "", "..", "..\\..\\windows\\win", "../etc", "sub\\berry", "sub/berry",
+        "c:berry", "berry.png", "Oran-Berry", "oran berry", "caf\xC3\xA9-berry", "berry\n" };
+    for (const char* key : rejected) CHECK(!isItemKey(key));
+    CHECK(!isItemKey(std::string(33, 'a')));
+    CHECK(!isItemKey(std::string("oran\0berry", 10)));
+
+    ItemTable items;
+    CHECK_EQUAL(items.internSaved("..\\..\\evil"), -1);
+    CHECK_EQUAL(items.internSaved("sitrus-berry"), items.find("sitrus-berry"));
+    CHECK_EQUAL(items.size(), foundItemCount);
+}
+
+// A save cannot grow the table past maxItemKinds; known keys still resolve.
+static void testSavedKeyCap() {
+    ItemTable items;
+    int added = 0;
+    for (int i = 0; i < 1000; ++i)
+        if (items.internSaved("item-" + std::to_string(i)) >= 0) ++added;
+    CHECK_EQUAL(added, maxItemKinds - foundItemCount);
+    CHECK_EQUAL(items.size(), maxItemKinds);
+    CHECK_EQUAL(items.internSaved("item-0"), foundItemCount);
+    CHECK_EQUAL(items.internSaved("oran-berry"), 0);
+}
+
+// A bag with thousands of distinct keys keeps stable ids and strings.
+static void testManyKeys() {
+    ItemTable items;
+    const int count = 20000;
+    for (int i = 0; i < count; ++i)
+        CHECK_EQUAL(items.intern("item-" + std::to_string(i)), foundItemCount + i);
+    CHECK_EQUAL(items.size(), foundItemCount + count);
+    for (int i = 0; i < count; i += 97) {
+        std::string key = "item-" + std::to_string(i);
+        int id = items.find(key);
+        CHECK_EQUAL(id, foundItemCount + i);
+        CHECK(items.key(id) == key);
+        CHECK(same(items.iconPath(id), (L"assets\\berries\\item-" + std::to_wstring(i) + L".png").c_str()));
+    }
+}
+
+int main() {
+    testFoundItems();
+    testIntern();
+    testItemKeys();
+    testSavedKeyCap();
+    testManyKeys();
+    return checkResult();
+}
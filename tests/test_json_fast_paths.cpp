@@ -0,0 +1,355 @@
+// json.hpp's fast paths against the slow ones they stand in for, on random
+// input: plain_ascii_run against a byte loop, the contiguous-input lexer
+// against istream input (which still goes byte by byte), string views for
+// every contiguous input type, number conversion against strtod and
+// strtoll/strtoull, dump_integer against printf, and dump_escaped against
+// a reference escaper. Built twice, with and without JSON_NO_SIMD, so the
+// SSE2 and scalar runs are both checked.
+
+#include "check.hpp"
+#include "json.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Configuration json.hpp works out for itself stays inside it.
+#if defined(JSON_USE_SSE2) || defined(JSON_EXACT_DOUBLE_ARITHMETIC)
+#error "json.hpp leaks its SIMD or float configuration macros"
+#endif
+
+using nlohmann::json;
+
+static std::mt19937 rng(2024);
+
+static int below(int n) { return (int)(rng() % (unsigned)n); }
+
+static size_t referenceRun(const char* p, size_t n, bool stopAtDel) {
+    size_t i = 0;
+    for (; i < n; ++i) {
+        unsigned char c = (unsigned char)p[i];
+        if (c < 0x20 || c >= (stopAtDel ? 0x7F : 0x80) || c == '"' || c == '\\') break;
+    }
+    return i;
+}
+
+// Mostly plain text with the odd byte the run has to stop at, at every
+// alignment and on both sides of a 16-byte block.
+static void testPlainAsciiRun() {
+    const unsigned char stops[] = { '"', '\\', 0x00, 0x1F, 0x7F, 0x80, 0xC3, 0xFF };
+    char buffer[96];
+    for (int iteration = 0; iteration < 200000; ++iteration) {
+        size_t n = (size_t)below(80);
+        for (size_t i = 0; i < n; ++i) buffer[i] = (char)(0x20 + below(0x5F));
+        int specials = below(3);
+        for (int s = 0; s < specials && n; ++s)
+            buffer[below((int)n)] = (char)stops[below(sizeof(stops))];
+        size_t offset = (size_t)below(16);
+        std::memmove(buffer + offset, buffer, n);
+        for (bool stopAtDel : { false, true })
+            CHECK_EQUAL(nlohmann::detail::plain_ascii_run(buffer + offset, n, stopAtDel),
+                referenceRun(buffer + offset, n, stopAtDel));
+    }
+}
+
+static const char* const fragments[] = {
+    "{", "}", "[", "]", ",", ":", " ", "\n", "\t", "true", "false", "null", "tru", "nul",
+    "0", "-0", "12", "-7.5", "1e5", "2.5E-3", "1.", "01", "-", "1e", "123456789012345678901234",
+    "\"\"", "\"key\"", "\"plain text long enough to fill a couple of sse blocks\"",
+    "\"esc\\\"aped\\\\\\n\\u00e9\\ud83c\\udf52\"", "\"caf\xC3\xA9 \xE2\x82\xAC\xF0\x9F\x8D\x92\"",
+    "\"bad \xC3\"", "\"bad \xFF byte\"", "\"ctrl \x01\"", "\"del \x7F\"", "\"\\x\"", "\"\\u12\"",
+    "\"unterminated", "/* c */", "// c\n", "\xEF\xBB\xBF",
+};
+
+static std::string randomDocument() {
+    std::string text;
+    int pieces = 1 + below(30);
+    for (int i = 0; i < pieces; ++i) text += fragments[below(sizeof(fragments) / sizeof(fragments[0]))];
+    // Mostly well formed documents too, so the success path gets exercised.
+    if (below(2)) {
+        json j = json::object();
+        for (int k = below(6); k > 0; --k)
+            j[std::string(fragments[below(10)]) + std::to_string(k)] = { below(1000), "value \xC3\xA9\"\\", 0.1 * below(99) };
+        text = below(4) ? j.dump() : j.dump(2);
+    }
+    return text;
+}
+
+// The dumped value, or the message of the error (number overflow included).
+template <typename Input>
+static std::string parseResult(Input&& input, bool comments) {
+    try {
+        return json::parse(std::forward<Input>(input), nullptr, true, comments).dump();
+    } catch (const json::exception& e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+// Same document, same value or the same error message and byte position.
+static void testContiguousLexer() {
+    for (int iteration = 0; iteration < 30000; ++iteration) {
+        std::string text = randomDocument();
+        bool comments = below(2) != 0;
+        std::istringstream stream(text);
+        std::string viaStream = parseResult(stream, comments);
+        std::string viaPointers;
+        try {
+            viaPointers = json::parse(text.data(), text.data() + text.size(), nullptr, true, comments).dump();
+        } catch (const json::exception& e) {
+            viaPointers = std::string("error: ") + e.what();
+        }
+        CHECK(viaPointers == viaStream);
+        CHECK(parseResult(text, comments) == viaStream);
+        if (viaPointers != viaStream) std::fprintf(stderr, "  document: %s\n", text.c_str());
+    }
+}
+
+// Counts which way each key and string reached the handler.
+struct ViewCounter : nlohmann::json_sax<json> {
+    int views = 0, copies = 0;
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t) override { return true; }
+    bool number_unsigned(number_unsigned_t) override { return true; }
+    bool number_float(number_float_t, const string_t&) override { return true; }
+    bool string(string_t&) override { ++copies; return true; }
+    bool binary(binary_t&) override { return true; }
+    bool start_object(std::size_t) override { return true; }
+    bool key(string_t&) override { ++copies; return true; }
+    bool end_object() override { return true; }
+    bool start_array(std::size_t) override { return true; }
+    bool end_array() override { return true; }
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override { return false; }
+
+    bool key_view(const char*, std::size_t) { ++views; return true; }
+    bool string_view(const char*, std::size_t) { ++views; return true; }
+};
+
+template <typename Input>
+static void checkViews(const Input& input) {
+    ViewCounter counter;
+    CHECK(json::sax_parse(input, &counter));
+    CHECK_EQUAL(counter.views, 3);
+    CHECK_EQUAL(counter.copies, 1);
+}
+
+// Strings without escapes come straight from the input whichever contiguous
+// container holds it, not only from a pointer range.
+static void testStringViews() {
+    const std::string text = "{\"species\":\"bulbasaur\",\"note\":\"tab\\there\"}";
+    checkViews(text);
+    checkViews(std::vector<char>(text.begin(), text.end()));
+    checkViews(std::vector<unsigned char>(text.begin(), text.end()));
+    checkViews(text.c_str());
+}
+
+static uint64_t bitsOf(double d) {
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static std::string randomNumber() {
+    std::string text;
+    if (below(2)) text += '-';
+    int integerDigits = 1 + below(20);
+    text += (char)('1' + below(9));
+    for (int i = 1; i < integerDigits; ++i) text += (char)('0' + below(10));
+    if (below(3)) {
+        text += '.';
+        for (int i = 1 + below(20); i > 0; --i) text += (char)('0' + below(10));
+    }
+    if (below(2)) text += "e" + std::to_string(below(80) - 40);
+    else if (text.find('.') == std::string::npos) text += ".0";
+    return text;
+}
+
+// Parsed numbers match strtod bit for bit, and every dumped double reads
+// back as itself.
+static void testNumbers() {
+    const char* edges[] = { "9007199254740993.0", "9007199254740992e3", "1e22", "1e23", "123456789e-22",
+        "4.35.0", "0.1", "5e-324", "1.7976931348623157e308", "2.2250738585072011e-308", "0.30000000000000004" };
+    for (int iteration = 0; iteration < 200000; ++iteration) {
+        std::string text = iteration < 11 ? edges[iteration] : randomNumber();
+        json parsed = json::parse(text, nullptr, false);
+        if (parsed.is_discarded()) continue;
+        double expected = std::strtod(text.c_str(), nullptr);
+        CHECK_EQUAL(bitsOf(parsed.get<double>()), bitsOf(expected));
+        std::string dumped = parsed.dump();
+        CHECK_EQUAL(bitsOf(std::strtod(dumped.c_str(), nullptr)), bitsOf(expected));
+    }
+    for (int iteration = 0; iteration < 100000; ++iteration) {
+        double value = below(2) ? below(1000000) / std::pow(10.0, below(8)) : std::ldexp((double)rng(), below(200) - 100);
+        std::string dumped = json(value).dump();
+        CHECK_EQUAL(bitsOf(json::parse(dumped).get<double>()), bitsOf(value));
+    }
+}
+
+// An integer of 1 to 20 digits, with a sign half the time.
+static std::string randomInteger() {
+    std::string text = below(2) ? "-" : "";
+    int digits = 1 + below(20);
+    text += (char)((digits == 1 ? '0' : '1') + below(digits == 1 ? 10 : 9));
+    for (int i = 1; i < digits; ++i) text += (char)('0' + below(10));
+    return text;
+}
+
+// Integers come out as strtoll/strtoull read them, and those out of 64-bit
+// range as the double strtod reads.
+static void checkParsedInteger(const std::string& text) {
+    json parsed = json::parse(text);
+    errno = 0;
+    bool negative = text[0] == '-';
+    long long asSigned = negative ? std::strtoll(text.c_str(), nullptr, 10) : 0;
+    unsigned long long asUnsigned = negative ? 0 : std::strtoull(text.c_str(), nullptr, 10);
+    if (errno == ERANGE) {
+        CHECK(parsed.is_number_float());
+        CHECK_EQUAL(bitsOf(parsed.get<double>()), bitsOf(std::strtod(text.c_str(), nullptr)));
+    } else if (negative) {
+        CHECK(parsed.is_number_integer() && !parsed.is_number_unsigned());
+        CHECK(parsed.get<long long>() == asSigned);
+    } else {
+        CHECK(parsed.is_number_unsigned());
+        CHECK(parsed.get<unsigned long long>() == asUnsigned);
+    }
+}
+
+static void testIntegers() {
+    const char* edges[] = { "0", "-0", "1", "-1", "9223372036854775807", "9223372036854775808",
+        "-9223372036854775807", "-9223372036854775808", "-9223372036854775809", "18446744073709551615",
+        "18446744073709551616", "99999999999999999999", "-99999999999999999999", "999999999999999999",
+        "1000000000000000000", "9999999999999999999", "10000000000000000000" };
+    for (const char* edge : edges) checkParsedInteger(edge);
+    for (int iteration = 0; iteration < 200000; ++iteration) checkParsedInteger(randomInteger());
+
+    // The overflowing edges become doubles rather than wrapping.
+    CHECK(json::parse("18446744073709551616").is_number_float());
+    CHECK(json::parse("-9223372036854775809").is_number_float());
+    CHECK(json::parse("18446744073709551615").get<uint64_t>() == UINT64_MAX);
+    CHECK(json::parse("-9223372036854775808").get<int64_t>() == INT64_MIN);
+}
+
+static void checkDumpedInteger(int64_t value) {
+    char expected[32];
+    std::snprintf(expected, sizeof(expected), "%lld", (long long)value);
+    CHECK(json(value).dump() == expected);
+}
+
+static void checkDumpedInteger(uint64_t value) {
+    char expected[32];
+    std::snprintf(expected, sizeof(expected), "%llu", (unsigned long long)value);
+    CHECK(json(value).dump() == expected);
+}
+
+// Integers are written exactly as printf writes them: either side of every
+// power of ten, at the type limits, and at random magnitudes.
+static void testDumpIntegers() {
+    checkDumpedInteger(int64_t(0));
+    checkDumpedInteger(uint64_t(0));
+    checkDumpedInteger(int64_t(1));
+    checkDumpedInteger(int64_t(-1));
+    checkDumpedInteger(INT64_MIN);
+    checkDumpedInteger(INT64_MAX);
+    checkDumpedInteger(UINT64_MAX);
+    uint64_t power = 1;
+    for (int digits = 1; digits <= 19; ++digits) {
+        power *= 10;
+        for (uint64_t value : { power - 1, power, power + 1 }) {
+            checkDumpedInteger(value);
+            if (value <= (uint64_t)INT64_MAX) {
+                checkDumpedInteger((int64_t)value);
+                checkDumpedInteger(-(int64_t)value);
+            }
+        }
+    }
+    std::mt19937_64 wide(45);
+    for (int iteration = 0; iteration < 200000; ++iteration) {
+        uint64_t bits = wide() >> below(64);
+        checkDumpedInteger(bits);
+        checkDumpedInteger((int64_t)bits);
+        checkDumpedInteger((int64_t)wide());
+    }
+}
+
+static void appendEscaped(std::string& out, uint32_t cp) {
+    char hex[16];
+    std::snprintf(hex, sizeof(hex), "\\u%04x", (unsigned)cp);
+    out += hex;
+}
+
+// The plain serializer, one code point at a time.
+static std::string referenceDump(const std::string& s, bool ensureAscii) {
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size();) {
+        unsigned char c = (unsigned char)s[i];
+        int length = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        uint32_t cp = length == 1 ? c : c & (0x7F >> length);
+        for (int k = 1; k < length; ++k) cp = (cp << 6) | ((unsigned char)s[i + k] & 0x3F);
+        switch (cp) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (cp < 0x20 || (ensureAscii && cp >= 0x7F)) {
+                if (cp > 0xFFFF) {
+                    appendEscaped(out, 0xD7C0 + (cp >> 10));
+                    appendEscaped(out, 0xDC00 + (cp & 0x3FF));
+                } else {
+                    appendEscaped(out, cp);
+                }
+            } else {
+                out.append(s, i, (size_t)length);
+            }
+        }
+        i += (size_t)length;
+    }
+    return out + "\"";
+}
+
+static void testDumpEscaped() {
+    const char* pieces[] = { "a", "plain run of text ", "\"", "\\", "\n", "\x01", "\x1F", "\x7F", "~",
+        "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x8D\x92", "\xEF\xBF\xBF" };
+    for (int iteration = 0; iteration < 100000; ++iteration) {
+        std::string s;
+        for (int n = below(24); n > 0; --n) s += pieces[below(sizeof(pieces) / sizeof(pieces[0]))];
+        for (bool ensureAscii : { false, true }) {
+            std::string dumped = json(s).dump(-1, ' ', ensureAscii);
+            CHECK(dumped == referenceDump(s, ensureAscii));
+            CHECK(json::parse(dumped).get<std::string>() == s);
+        }
+
+        // A stray continuation byte is still rejected wherever it falls.
+        std::string bad = s;
+        bad.insert((size_t)below((int)s.size() + 1), 1, (char)(0x80 + below(0x40)));
+        bool threw = false;
+        try {
+            json(bad).dump();
+        } catch (const json::type_error& e) {
+            threw = e.id == 316;
+        }
+        CHECK(threw);
+    }
+}
+
+int main() {
+    testPlainAsciiRun();
+    testContiguousLexer();
+    testStringViews();
+    testNumbers();
+    testIntegers();
+    testDumpIntegers();
+    testDumpEscaped();
+    return checkResult();
+}
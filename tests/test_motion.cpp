@@ -0,0 +1,106 @@
+#include "check.hpp"
+#include "pet_world.hpp"
+
+#include <cmath>
+
+static void testClockSteps() {
+    MotionClock clock;
+    CHECK_EQUAL(clock.advance(5000), 0u); // the first tick only starts the clock
+    CHECK_EQUAL(clock.advance(5016), 1u);
+    CHECK_EQUAL(clock.carry, 6u);
+    CHECK(std::fabs(clock.alpha() - 0.6f) < 1e-6f);
+    CHECK_EQUAL(clock.advance(5020), 1u); // 6 ms carried + 4 ms
+    CHECK_EQUAL(clock.carry, 0u);
+    CHECK_EQUAL(clock.advance(5020), 0u);
+}
+
+static void testClockCatchUpCap() {
+    MotionClock clock;
+    clock.advance(0);
+    CHECK_EQUAL(clock.advance(60000), motionMaxCatchUpMs / motionStepMs);
+    // The tick counter wraps after 49 days; elapsed time must not.
+    MotionClock wrap;
+    wrap.advance(0xFFFFFFF0u);
+    CHECK_EQUAL(wrap.advance(0x00000014u), 3u);
+}
+
+// Every tick rate covers the same simulated time in the same whole steps.
+static void testStepsIndependentOfTickRate() {
+    const uint32_t rates[] = { 1, 16, 33, 50, 240 };
+    for (uint32_t rate : rates) {
+        MotionClock clock;
+        clock.advance(0);
+        unsigned steps = 0;
+        uint32_t now = 0;
+        while (now + rate <= 2400) steps += clock.advance(now += rate);
+        CHECK_EQUAL(steps * motionStepMs + clock.carry, now);
+    }
+}
+
+static PetWorld walkingWorld(const DisplayGeometry* display, int px) {
+    PetWorld world;
+    SpeciesInfo info;
+    info.name = "test";
+    info.width = info.height = 64;
+    for (uint16_t& n : info.frameCount) n = 4;
+    world.display = display;
+    world.spawn(world.addSpecies(info), px, 1000);
+    enterState(world.machine[0], STATE_WALK);
+    world.machine[0].facingRight = true;
+    return world;
+}
+
+static void testWalkDistance() {
+    PetWorld a = walkingWorld(nullptr, 100);
+    PetWorld b = walkingWorld(nullptr, 100);
+    // One second as 100 single steps, and as 4 catch-up batches.
+    for (int i = 0; i < 100; ++i) a.integrate(1);
+    for (int i = 0; i < 4; ++i) b.integrate(25);
+    float expected = 100 + defaultWalkSpeed;
+    CHECK(std::fabs(a.posX[0] - expected) < 0.01f);
+    CHECK(std::fabs(b.posX[0] - expected) < 0.01f);
+    CHECK(std::fabs(b.prevX[0] - (expected - defaultWalkSpeed * motionStepMs / 1000)) < 0.01f);
+
+    // Presented halfway between the last two steps, rounded to a pixel.
+    b.present(0.5f);
+    CHECK_EQUAL(b.x[0], (int)std::floor(b.prevX[0] + (b.posX[0] - b.prevX[0]) * 0.5f + 0.5f));
+    CHECK(b.grid.boundsOf(0) == b.footprint(0));
+
+    // Pets that are not walking stay put and stop interpolating.
+    enterState(b.machine[0], STATE_IDLE);
+    float at = b.posX[0];
+    b.integrate(10);
+    CHECK(b.posX[0] == at);
+    CHECK(b.prevX[0] == at);
+}
+
+static void testStopAtEdge() {
+    DisplayGeometry display;
+    std::vector<MonitorArea> layout(1);
+    layout[0].monitor = { 0, 0, 1920, 1080 };
+    layout[0].primary = true;
+    display.setLayout(layout, Bounds{});
+
+    PetWorld world = walkingWorld(&display, 1920 - 64 - 1);
+    world.integrate(25);
+    CHECK(world.posX[0] == 1920.0f - 64);
+    CHECK(world.prevX[0] == world.posX[0]);
+    CHECK_EQUAL(world.machine[0].state, STATE_TRIP);
+    CHECK(!world.machine[0].facingRight);
+
+    world = walkingWorld(&display, 1);
+    world.machine[0].facingRight = false;
+    world.integrate(25);
+    CHECK(world.posX[0] == 0.0f);
+    CHECK_EQUAL(world.machine[0].state, STATE_TRIP);
+    CHECK(world.machine[0].facingRight);
+}
+
+int main() {
+    testClockSteps();
+    testClockCatchUpCap();
+    testStepsIndependentOfTickRate();
+    testWalkDistance();
+    testStopAtEdge();
+    return checkResult();
+}
@@ -0,0 +1,140 @@
+#include "check.hpp"
+#include "pet_fsm.hpp"
+
+// Where every state goes on every event; -1 where the event is ignored.
+constexpr int expectedTransitions[STATE_COUNT][EVENT_COUNT] = {
+    //                CLICK        FOUND_ITEM      FEED       SLEEP_TIMEOUT  BUMP
+    /* IDLE     */ { STATE_WALK,  STATE_FINDITEM, STATE_EAT, STATE_SLEEP,   -1 },
+    /* WALK     */ { -1,          STATE_FINDITEM, STATE_EAT, STATE_SLEEP,   STATE_TRIP },
+    /* SLEEP    */ { STATE_WAKE,  -1,             STATE_EAT, -1,            -1 },
+    /* WAKE     */ { -1,          STATE_FINDITEM, STATE_EAT, -1,            -1 },
+    /* TRIP     */ { -1,          STATE_FINDITEM, STATE_EAT, -1,            -1 },
+    /* FINDITEM */ { -1,          -1,             STATE_EAT, -1,            -1 },
+    /* EAT      */ { -1,          -1,             STATE_EAT, -1,            -1 },
+};
+
+// The same lookup firePetEvent() does, at compile time.
+constexpr int transitionTarget(PetState s, PetEvent e) {
+    for (const Transition& t : transitionTable)
+        if (t.event == e && (t.from & stateBit(s))) return t.to;
+    return -1;
+}
+
+static_assert(transitionTarget(STATE_IDLE, EVENT_CLICK) == STATE_WALK, "a click sets an idle pet walking");
+static_assert(transitionTarget(STATE_EAT, EVENT_FOUND_ITEM) == -1, "finding an item must not cut a meal short");
+
+// Plays animations of a fixed length and records what it was asked to do.
+struct FakePlayer {
+    int length = 3;
+    int frame = 0;
+    int restarts = 0;
+    PetAnim lastAnim = ANIM_COUNT;
+
+    void restart(PetAnim anim) {
+        frame = 0;
+        ++restarts;
+        lastAnim = anim;
+    }
+
+    bool advance(PetAnim anim) {
+        lastAnim = anim;
+        if (++frame < length) return false;
+        frame = 0;
+        return true;
+    }
+};
+
+static void testTransitionTable() {
+    for (int s = 0; s < STATE_COUNT; ++s) {
+        for (int e = 0; e < EVENT_COUNT; ++e) {
+            PetMachine m;
+            m.state = (PetState)s;
+            bool accepted = firePetEvent(m, (PetEvent)e);
+            int expected = expectedTransitions[s][e];
+            CHECK_EQUAL(accepted, expected >= 0);
+            CHECK_EQUAL(m.state, expected >= 0 ? expected : s);
+            CHECK_EQUAL(transitionTarget((PetState)s, (PetEvent)e), expected);
+            if (accepted) {
+                CHECK_EQUAL(m.previous, s);
+                CHECK(m.restart);
+            }
+        }
+    }
+}
+
+static void testDirectionalAnims() {
+    PetMachine m;
+    enterState(m, STATE_WALK);
+    m.facingRight = false;
+    CHECK_EQUAL(currentAnim(m), ANIM_WALK_LEFT);
+    m.restart = false;
+    setFacing(m, true);
+    CHECK_EQUAL(currentAnim(m), ANIM_WALK_RIGHT);
+    CHECK(m.restart);
+
+    // Idle has one animation, so turning does not rewind it.
+    enterState(m, STATE_IDLE);
+    m.restart = false;
+    setFacing(m, false);
+    CHECK_EQUAL(currentAnim(m), ANIM_IDLE);
+    CHECK(!m.restart);
+}
+
+static void testFrameTiming() {
+    PetMachine m;
+    FakePlayer player;
+    uint32_t now = 1000;
+
+    CHECK_EQUAL(tickPetMachine(m, now, player), EFFECT_NONE);
+    CHECK_EQUAL(player.restarts, 1);
+    CHECK_EQUAL(player.frame, 1);
+
+    // Not due yet, then due within the tick slack.
+    CHECK_EQUAL(tickPetMachine(m, now + 100, player), EFFECT_NONE);
+    CHECK_EQUAL(player.frame, 1);
+    CHECK_EQUAL(tickPetMachine(m, now + animIntervalIdle - tickSlack, player), EFFECT_NONE);
+    CHECK_EQUAL(player.frame, 2);
+
+    // Idle loops: wrapping stays in the state and reports nothing.
+    now += 2 * animIntervalIdle;
+    CHECK_EQUAL(tickPetMachine(m, now, player), EFFECT_NONE);
+    CHECK_EQUAL(m.state, STATE_IDLE);
+    CHECK_EQUAL(player.frame, 0);
+}
+
+static void testFeedingEndsAfterEating() {
+    PetMachine m;
+    FakePlayer player;
+    uint32_t now = 0;
+    tickPetMachine(m, now, player);
+
+    CHECK(firePetEvent(m, EVENT_FEED));
+    CHECK(!firePetEvent(m, EVENT_FOUND_ITEM));
+    unsigned effects = EFFECT_NONE;
+    for (int i = 0; i < player.length; ++i) {
+        now += animIntervalEat;
+        effects = tickPetMachine(m, now, player);
+        CHECK_EQUAL(player.lastAnim, ANIM_EAT);
+    }
+    CHECK_EQUAL(effects, EFFECT_FEED_DONE | EFFECT_ENTERED);
+    CHECK_EQUAL(m.state, STATE_IDLE);
+}
+
+static void testTickIntervals() {
+    PetMachine m;
+    CHECK_EQUAL(tickIntervalFor(m, 16), 16u);
+    enterState(m, STATE_SLEEP);
+    CHECK_EQUAL(tickIntervalFor(m, 16), animIntervalSleep);
+    CHECK(!isMoving(m));
+    enterState(m, STATE_WALK);
+    CHECK(isMoving(m));
+}
+
+int main() {
+    testTransitionTable();
+    testDirectionalAnims();
+    testFrameTiming();
+    testFeedingEndsAfterEating();
+    testTickIntervals();
+    return checkResult();
+}
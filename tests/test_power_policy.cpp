@@ -0,0 +1,50 @@
+#include "check.hpp"
+#include "power_policy.hpp"
+
+static void testModes() {
+    PowerPolicy p;
+    CHECK_EQUAL(p.mode(), POWER_NORMAL);
+    CHECK_EQUAL(p.tickInterval(16), 16u);
+
+    CHECK(p.apply({ SIGNAL_ON_BATTERY, true }));
+    CHECK_EQUAL(p.mode(), POWER_REDUCED);
+    CHECK_EQUAL(p.tickInterval(16), reducedTickInterval);
+    CHECK_EQUAL(p.tickInterval(800), 800u); // already slower than the floor
+
+    // Suspension wins over battery, and lifting it falls back to reduced.
+    CHECK(p.apply({ SIGNAL_SESSION_LOCKED, true }));
+    CHECK_EQUAL(p.mode(), POWER_SUSPENDED);
+    CHECK_EQUAL(p.tickInterval(16), 0u);
+    CHECK(!p.apply({ SIGNAL_DISPLAY_OFF, true }));
+    CHECK(!p.apply({ SIGNAL_SESSION_LOCKED, false }));
+    CHECK(p.apply({ SIGNAL_DISPLAY_OFF, false }));
+    CHECK_EQUAL(p.mode(), POWER_REDUCED);
+
+    // Repeated notifications change nothing.
+    CHECK(!p.apply({ SIGNAL_ON_BATTERY, true }));
+    CHECK(p.apply({ SIGNAL_ON_BATTERY, false }));
+    CHECK_EQUAL(p.mode(), POWER_NORMAL);
+}
+
+static void testReplay() {
+    // Unplugged, a fullscreen game starts and ends, then the machine is locked and unlocked.
+    const PowerEvent recorded[] = {
+        { SIGNAL_ON_BATTERY, true },
+        { SIGNAL_FULLSCREEN_APP, true },
+        { SIGNAL_FULLSCREEN_APP, false },
+        { SIGNAL_SESSION_LOCKED, true },
+        { SIGNAL_SESSION_LOCKED, false },
+    };
+    PowerPolicy p;
+    CHECK(p.replay(recorded, sizeof(recorded) / sizeof(recorded[0])));
+    CHECK_EQUAL(p.mode(), POWER_REDUCED);
+    CHECK(p.has(SIGNAL_ON_BATTERY));
+    CHECK(!p.has(SIGNAL_FULLSCREEN_APP));
+    CHECK(!p.replay(recorded + 4, 1));
+}
+
+int main() {
+    testModes();
+    testReplay();
+    return checkResult();
+}
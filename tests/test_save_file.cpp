@@ -0,0 +1,179 @@
+#include "check.hpp"
+#include "save_schema.hpp"
+
+#include <map>
+#include <string>
+
+// A framed save whose first pet stands at `x`.
+static std::string framedSave(int x) {
+    SaveArenaScope arenaScope;
+    SaveJson j;
+    j["version"] = saveSchemaVersion;
+    j["pet"] = { { "species", "bulbasaur" }, { "x", x }, { "y", 1016 } };
+    j["exploreMode"] = true;
+    j["bag"] = { { "oran-berry", 3 }, { "pokeball", 1 } };
+    std::string payload = j.dump();
+    char header[saveHeaderMax];
+    size_t headerSize = saveFrameHeader(payload.data(), payload.size(), header);
+    return std::string(header, headerSize) + payload;
+}
+
+// The pet's x from a save file's bytes, or -1 when the loader rejects them.
+static int loadedX(const std::string& file) {
+    SaveArenaScope arenaScope;
+    SaveJson j;
+    if (!parseSave(file.data(), file.size(), j)) return -1;
+    return j["pet"]["x"].get<int>();
+}
+
+static void testFrame() {
+    std::string file = framedSave(640);
+    const char* payload = nullptr;
+    size_t payloadSize = 0;
+    CHECK_EQUAL(unframeSave(file.data(), file.size(), payload, payloadSize), SAVE_OK);
+    CHECK_EQUAL(payload[0], '{');
+    CHECK(payload + payloadSize == file.data() + file.size());
+    CHECK_EQUAL(loadedX(file), 640);
+    CHECK_EQUAL(crc32("123456789", 9), 0xCBF43926u);
+}
+
+// Every proper prefix of a save is what a torn write leaves behind.
+static void testTruncatedAtEveryOffset() {
+    std::string file = framedSave(640);
+    for (size_t size = 0; size < file.size(); ++size) {
+        const char* payload;
+        size_t payloadSize;
+        CHECK_EQUAL(unframeSave(file.data(), size, payload, payloadSize), SAVE_CORRUPT);
+        CHECK_EQUAL(loadedX(file.substr(0, size)), -1);
+    }
+}
+
+// A flipped bit is rejected, or lands somewhere that reads the same (the
+// checksum's hex digits are case-insensitive).
+static void testEveryBitFlip() {
+    std::string file = framedSave(640);
+    for (size_t i = 0; i < file.size(); ++i) {
+        for (int bit = 0; bit < 8; ++bit) {
+            std::string flipped = file;
+            flipped[i] = (char)(flipped[i] ^ (1 << bit));
+            int x = loadedX(flipped);
+            CHECK(x == -1 || x == 640);
+        }
+    }
+}
+
+static void testLegacySave() {
+    std::string legacy = R"({"pokemon":"charmander","posX":10,"posY":20,"exploreMode":false,"bag":{}})";
+    const char* payload;
+    size_t payloadSize;
+    CHECK_EQUAL(unframeSave(legacy.data(), legacy.size(), payload, payloadSize), SAVE_LEGACY);
+    CHECK_EQUAL(loadedX(legacy), 10);
+    CHECK_EQUAL(loadedX("not json"), -1);
+    CHECK_EQUAL(loadedX("[1, 2]"), -1);
+}
+
+// The files saveData() touches, with its steps as atomic operations: write
+// data.json.tmp, then ReplaceFile (data.json -> .bak, .tmp -> data.json), or
+// MoveFileEx for the first save and over a data.json that failed its check.
+// A crash can stop it anywhere; stopping after the write or between the two
+// renames is also what ReplaceFile leaves when it fails with
+// ERROR_UNABLE_TO_MOVE_REPLACEMENT or ERROR_UNABLE_TO_MOVE_REPLACEMENT_2.
+struct Disk {
+    std::map<std::string, std::string> files;
+    bool dataValid = false; // what loadData() found data.json to be
+
+    bool has(const char* name) const { return files.count(name) != 0; }
+
+    int x(const char* name) const {
+        auto file = files.find(name);
+        return file == files.end() ? -1 : loadedX(file->second);
+    }
+
+    void rename(const char* from, const char* to) {
+        files[to] = files[from];
+        files.erase(from);
+    }
+
+    // Returns how many steps ran; `crashAfter` stops it early, and a crash
+    // inside the write leaves the first `tornAt` bytes of the temp file.
+    int save(const std::string& file, int crashAfter, size_t tornAt) {
+        files["data.json.tmp"] = file.substr(0, tornAt);
+        if (crashAfter == 0 || tornAt < file.size()) return 0;
+        if (!dataValid || !has("data.json")) {
+            rename("data.json.tmp", "data.json");
+            dataValid = true;
+            return 2;
+        }
+        rename("data.json", "data.json.bak");
+        if (crashAfter == 1) return 1;
+        rename("data.json.tmp", "data.json");
+        return 2;
+    }
+
+    // What loadData() does: a finished data.json.tmp, else data.json, else
+    // the backup.
+    int load() {
+        int data = x("data.json");
+        dataValid = data >= 0;
+        int pending = x("data.json.tmp");
+        if (pending >= 0) return pending;
+        return dataValid ? data : x("data.json.bak");
+    }
+};
+
+static void testCrashDuringSave() {
+    std::string older = framedSave(100), old = framedSave(200), next = framedSave(300), later = framedSave(400);
+    for (int crashAfter = 0; crashAfter <= 2; ++crashAfter) {
+        for (size_t tornAt = 0; tornAt <= next.size(); ++tornAt) {
+            Disk disk;
+            disk.files["data.json.bak"] = older;
+            disk.files["data.json"] = old;
+            disk.load();
+            disk.save(next, crashAfter, tornAt);
+            // Once the write is complete the new save survives, however far
+            // the swap got.
+            int x = disk.load();
+            CHECK_EQUAL(x, tornAt == next.size() ? 300 : 200);
+
+            // The save after restarting lands, with a good backup behind it.
+            CHECK_EQUAL(disk.save(later, 2, later.size()), 2);
+            CHECK_EQUAL(disk.load(), 400);
+            int backup = disk.x("data.json.bak");
+            CHECK(backup == 100 || backup == 200 || backup == 300);
+        }
+    }
+
+    // The first save: nothing to fall back on until it is complete.
+    for (size_t tornAt = 0; tornAt <= next.size(); ++tornAt) {
+        Disk disk;
+        disk.load();
+        disk.save(next, 2, tornAt);
+        CHECK_EQUAL(disk.load(), tornAt == next.size() ? 300 : -1);
+    }
+
+    // A write the disk reordered past the rename: data.json itself is torn,
+    // and the backup from before it is loaded. The saves after that go over
+    // the torn file and leave the backup alone, wherever they stop.
+    for (size_t corruptAt = 0; corruptAt < next.size(); ++corruptAt) {
+        for (int crashAfter = 0; crashAfter <= 2; ++crashAfter) {
+            for (size_t tornAt = 0; tornAt <= later.size(); ++tornAt) {
+                Disk disk;
+                disk.files["data.json.bak"] = old;
+                disk.files["data.json"] = next.substr(0, corruptAt);
+                CHECK_EQUAL(disk.load(), 200);
+                disk.save(later, crashAfter, tornAt);
+                CHECK_EQUAL(disk.x("data.json.bak"), 200);
+                CHECK_EQUAL(disk.load(), tornAt == later.size() ? 400 : 200);
+            }
+        }
+    }
+}
+
+int main() {
+    testFrame();
+    testTruncatedAtEveryOffset();
+    testEveryBitFlip();
+    testLegacySave();
+    testCrashDuringSave();
+    return checkResult();
+}
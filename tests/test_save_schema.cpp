@@ -0,0 +1,64 @@
+#include "check.hpp"
+#include "save_schema.hpp"
+
+#include <string>
+
+static SaveJson parsed(const char* text) { return SaveJson::parse(text); }
+
+static void testMigratesV1() {
+    SaveArenaScope arenaScope;
+    SaveJson j = parsed(R"({"pokemon":"charmander","posX":10,"posY":-20,"exploreMode":true,"bag":{"oran-berry":2}})");
+    CHECK_EQUAL(saveVersionOf(j), 1);
+    CHECK(migrateSave(j));
+    CHECK_EQUAL(saveVersionOf(j), saveSchemaVersion);
+    CHECK(j["pet"]["species"] == "charmander");
+    CHECK_EQUAL(j["pet"]["x"].get<int>(), 10);
+    CHECK_EQUAL(j["pet"]["y"].get<int>(), -20);
+    CHECK(!j.contains("pokemon") && !j.contains("posX") && !j.contains("posY"));
+    // Fields the layout change did not touch come through as they were.
+    CHECK(j["exploreMode"] == true);
+    CHECK_EQUAL(j["bag"]["oran-berry"].get<int>(), 2);
+    CHECK(!isNewerSave(j));
+
+    // A v1 save missing fields still migrates; the loader keeps its defaults.
+    SaveJson sparse = parsed(R"({"bag":{}})");
+    CHECK(migrateSave(sparse));
+    CHECK(sparse["pet"].is_object() && sparse["pet"].empty());
+}
+
+static void testCurrentIsUntouched() {
+    SaveArenaScope arenaScope;
+    SaveJson j = parsed(R"({"version":2,"pet":{"species":"bulbasaur","x":1,"y":2},"exploreMode":false,"bag":{}})");
+    SaveJson before = j;
+    CHECK(migrateSave(j));
+    CHECK(j == before);
+}
+
+// A save from a newer build keeps everything this build does not know, and
+// the host must not write it back.
+static void testNewerIsLeftAlone() {
+    SaveArenaScope arenaScope;
+    SaveJson j = parsed(R"({"version":3,"pets":[{"species":"eevee"}],"pet":{"x":5},"bag":{},"theme":"dark"})");
+    SaveJson before = j;
+    CHECK(migrateSave(j));
+    CHECK(j == before);
+    CHECK(isNewerSave(j));
+}
+
+static void testUnusableVersions() {
+    SaveArenaScope arenaScope;
+    const char* saves[] = { R"({"version":0})", R"({"version":-1})", R"({"version":"2"})", R"({"version":1.5})" };
+    for (const char* text : saves) {
+        SaveJson j = parsed(text);
+        CHECK(!migrateSave(j));
+        CHECK(!isNewerSave(j));
+    }
+}
+
+int main() {
+    testMigratesV1();
+    testCurrentIsUntouched();
+    testNewerIsLeftAlone();
+    testUnusableVersions();
+    return checkResult();
+}
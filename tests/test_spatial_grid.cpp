@@ -0,0 +1,80 @@
+#include "check.hpp"
+#include "spatial_grid.hpp"
+
+#include <random>
+#include <vector>
+
+// The answers the grid must give, by looking at every pet.
+static int linearHitTest(const std::vector<Bounds>& pets, int x, int y) {
+    for (int i = (int)pets.size() - 1; i >= 0; --i)
+        if (pets[i].contains(x, y)) return i;
+    return -1;
+}
+
+static std::vector<uint32_t> linearQuery(const std::vector<Bounds>& pets, const Bounds& area) {
+    std::vector<uint32_t> hits;
+    for (size_t i = 0; i < pets.size(); ++i)
+        if (intersects(pets[i], area)) hits.push_back((uint32_t)i);
+    return hits;
+}
+
+// Random pets on a desktop with a monitor left of and above the primary
+// one, so cell coordinates go negative.
+static Bounds randomPet(std::mt19937& rng) {
+    int x = -1920 + (int)(rng() % 5760), y = -1080 + (int)(rng() % 3240);
+    return boundsAt(x, y, 16 + (int)(rng() % 120), 16 + (int)(rng() % 120));
+}
+
+static void testAgainstLinearScan() {
+    std::mt19937 rng(5);
+    SpatialGrid grid;
+    std::vector<Bounds> pets;
+    for (int step = 0; step < 20000; ++step) {
+        unsigned op = rng() % 10;
+        if (op < 3 || pets.empty()) {
+            pets.push_back(randomPet(rng));
+            grid.insert(pets.back());
+        } else if (op < 4) {
+            uint32_t id = rng() % pets.size();
+            pets[id] = pets.back();
+            pets.pop_back();
+            grid.remove(id);
+        } else if (op < 7) {
+            uint32_t id = rng() % pets.size();
+            Bounds& b = pets[id];
+            int dx = (int)(rng() % 41) - 20, dy = (int)(rng() % 41) - 20;
+            b = { b.left + dx, b.top + dy, b.right + dx, b.bottom + dy };
+            grid.move(id, b);
+        } else {
+            int x = -2000 + (int)(rng() % 6000), y = -1100 + (int)(rng() % 3300);
+            CHECK_EQUAL(grid.hitTest(x, y), linearHitTest(pets, x, y));
+
+            Bounds area = boundsAt(x, y, 1 + (int)(rng() % 300), 1 + (int)(rng() % 300));
+            std::vector<uint32_t> seen(pets.size(), 0);
+            size_t visits = 0;
+            grid.query(area, [&](uint32_t id) {
+                ++seen[id];
+                ++visits;
+            });
+            std::vector<uint32_t> expected = linearQuery(pets, area);
+            CHECK_EQUAL(visits, expected.size());
+            for (uint32_t id : expected) CHECK_EQUAL(seen[id], 1);
+        }
+        CHECK_EQUAL(grid.size(), pets.size());
+    }
+}
+
+static void testEmptyGrid() {
+    SpatialGrid grid;
+    CHECK_EQUAL(grid.hitTest(0, 0), -1);
+    CHECK_EQUAL(grid.hitTest(-1, -1), -1);
+    int visits = 0;
+    grid.query(Bounds{ -100, -100, 100, 100 }, [&](uint32_t) { ++visits; });
+    CHECK_EQUAL(visits, 0);
+}
+
+int main() {
+    testAgainstLinearScan();
+    testEmptyGrid();
+    return checkResult();
+}
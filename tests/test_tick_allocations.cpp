@@ -0,0 +1,161 @@
+// Built with POKEBUDDY_ALLOC_GUARD: runs the portable part of the tick
+// (world, grid, composition planning, tick rate) headlessly and fails on
+// any heap allocation once the pets have settled, naming the stage that
+// made it.
+
+#include "alloc_guard.hpp"
+#include "check.hpp"
+#include "compositor.hpp"
+#include "display_geometry.hpp"
+#include "item_table.hpp"
+#include "pet_world.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <random>
+
+static int reports = 0;
+static bool printReports = true;
+static char lastReport[160];
+
+static void captureReport(const char* message) {
+    if (printReports && reports < 10) std::fputs(message, stderr);
+    ++reports;
+    std::snprintf(lastReport, sizeof(lastReport), "%s", message);
+}
+
+// Keeps the compiler from eliding a new/delete pair.
+static void* volatile escape;
+
+static void testGuardNamesTheStage() {
+    reports = 0;
+    {
+        AllocGuardScope guard;
+        ALLOC_STAGE("self-test");
+        escape = new int(1);
+    }
+    delete (int*)escape;
+    CHECK_EQUAL(reports, 1);
+    CHECK(std::strstr(lastReport, "4-byte heap allocation during tick stage 'self-test'") != nullptr);
+
+    // Outside a scope, or explicitly allowed, nothing is reported.
+    escape = new int(2);
+    delete (int*)escape;
+    {
+        AllocGuardScope guard;
+        ALLOC_STAGE("allowed");
+        AllocGuardAllow allow;
+        escape = new int(3);
+    }
+    delete (int*)escape;
+    CHECK_EQUAL(reports, 1);
+}
+
+// What tickWorld() does minus the windows: same stages, same order.
+struct Host {
+    DisplayGeometry display;
+    PetWorld world;
+    CompositionPlanner planner;
+    CompositionPlan plan;
+    std::vector<Bounds> petBounds;
+    Bounds compositeRegion;
+    unsigned interval = 16;
+
+    void tick(uint32_t now) {
+        AllocGuardScope guard;
+        ALLOC_STAGE("world.tick");
+        world.tick(now);
+
+        ALLOC_STAGE("renderPets");
+        size_t n = world.size();
+        petBounds.resize(n);
+        for (size_t i = 0; i < n; ++i) petBounds[i] = world.footprint(i);
+        planner.plan(petBounds.data(), n, compositeRegion, plan);
+
+        ALLOC_STAGE("applyTickRate");
+        interval = world.tickInterval(16);
+    }
+};
+
+static void testSteadyTickDoesNotAllocate() {
+    Host host;
+    std::vector<MonitorArea> layout(2);
+    layout[0].monitor = { 0, 0, 1920, 1080 };
+    layout[0].work = { 0, 0, 1920, 1040 };
+    layout[0].primary = true;
+    layout[1].monitor = { -1280, -200, 0, 824 };
+    layout[1].work = layout[1].monitor;
+    host.display.setLayout(layout, { 0, 1040, 1920, 1080 });
+    host.compositeRegion = host.display.taskbarStrip(64);
+    host.world.display = &host.display;
+
+    SpeciesInfo info;
+    info.name = "test";
+    info.width = info.height = 64;
+    for (uint16_t& n : info.frameCount) n = 4;
+    uint16_t species = host.world.addSpecies(info);
+
+    // Most pets on the taskbar, where they share a window, a few elsewhere.
+    for (int i = 0; i < 12; ++i) host.world.spawn(species, 200 + i * 130, 1080 - 64);
+    for (int i = 0; i < 4; ++i) host.world.spawn(species, -1200 + i * 300, 300);
+
+    // Clicks arrive between ticks, as window messages do.
+    std::mt19937 rng(7);
+    uint32_t now = 1000;
+    auto run = [&](int ticks) {
+        for (int t = 0; t < ticks; ++t) {
+            if (rng() % 8 == 0) {
+                size_t pet = rng() % host.world.size();
+                firePetEvent(host.world.machine[pet], rng() % 4 ? EVENT_CLICK : EVENT_FEED);
+            }
+            now += host.interval + rng() % 5;
+            host.tick(now);
+        }
+    };
+
+    // Warm-up: per-pet arrays settle, and walking pets reach every grid cell
+    // along their monitor (a cell's list is allocated the first time it
+    // holds a pet, and grows the first time it holds more than before).
+    printReports = false;
+    run(20000);
+
+    reports = 0;
+    printReports = true;
+    run(20000);
+    CHECK_EQUAL(reports, 0);
+}
+
+// Labels and paths are formatted on the stack and items are looked up by
+// id, so a menu sync or feeding costs nothing once the table is built.
+static void testLabelsDoNotAllocate() {
+    ItemTable items;
+    int candy = items.intern("rare-candy");
+    size_t length = 0;
+
+    reports = 0;
+    {
+        AllocGuardScope guard;
+        ALLOC_STAGE("bagLabel");
+        for (int id = 0; id < items.size(); ++id) {
+            TextBuilder<128> label;
+            label << items.displayName(id) << L" x " << id * 7;
+            PathBuilder path;
+            path << items.iconPath(id);
+            length += label.size() + path.size() + std::wcslen(items.eatAnimPath(id));
+        }
+        ALLOC_STAGE("ItemTable::find");
+        CHECK_EQUAL(items.find("rare-candy"), candy);
+        CHECK_EQUAL(items.find(foundItemKeys[0]), 0);
+    }
+    CHECK(length > 0);
+    CHECK_EQUAL(reports, 0);
+}
+
+int main() {
+    allocGuardReport = captureReport;
+    testGuardNamesTheStage();
+    testSteadyTickDoesNotAllocate();
+    testLabelsDoNotAllocate();
+    return checkResult();
+}
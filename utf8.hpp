@@ -0,0 +1,39 @@
+#pragma once
+
+// UTF-8 to wchar_t for item and species names from the save file: UTF-16
+// on Windows, UTF-32 where wchar_t is 32 bits. Malformed bytes become
+// U+FFFD instead of being widened one by one.
+
+#include <cstddef>
+#include <cstdint>
+
+// Calls emit(wchar_t) for every code unit of the decoded text.
+template <typename Emit>
+void decodeUtf8(const char* s, size_t n, Emit&& emit) {
+    static const uint32_t minimum[] = { 0, 0x80, 0x800, 0x10000 };
+    size_t i = 0;
+    while (i < n) {
+        unsigned char c = (unsigned char)s[i++];
+        int extra = c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+        uint32_t cp = 0xFFFD;
+        if (extra == 0) {
+            cp = c;
+        } else if (extra > 0 && n - i >= (size_t)extra) {
+            uint32_t v = c & (0x3F >> extra);
+            int k = 0;
+            for (; k < extra && ((unsigned char)s[i + k] & 0xC0) == 0x80; ++k)
+                v = (v << 6) | ((unsigned char)s[i + k] & 0x3F);
+            if (k == extra && v >= minimum[extra] && v <= 0x10FFFF && (v < 0xD800 || v > 0xDFFF)) {
+                cp = v;
+                i += extra;
+            }
+        }
+        if (sizeof(wchar_t) == 2 && cp > 0xFFFF) {
+            cp -= 0x10000;
+            emit((wchar_t)(0xD800 + (cp >> 10)));
+            emit((wchar_t)(0xDC00 + (cp & 0x3FF)));
+        } else {
+            emit((wchar_t)cp);
+        }
+    }
+}